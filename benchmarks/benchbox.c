@@ -0,0 +1,366 @@
+/*
+ * benchbox - end-to-end benchmark driver for the advbox tools.
+ *
+ * The tools are standalone binaries, so each case generates a synthetic
+ * workload in a throwaway directory, execs the tool over it, and times
+ * the run with CLOCK_MONOTONIC (one warmup, then best of three). Results
+ * go to stdout in a machine-readable form:
+ *
+ *     ADVBOX-BENCH name=<case> ops=<n> wall_ns=<t> ns_per_op=<x> bytes_per_op=<y> status=<ok|fail|info>
+ *
+ * When a baseline file is given, a case whose ns_per_op exceeds its
+ * threshold fails with exit code 1, so `meson test --benchmark` gates
+ * regressions. Baseline lines are `<case> <max_ns_per_op>`; '#' starts
+ * a comment; cases without an entry report status=info and pass.
+ *
+ * Usage: benchbox <case> <tool-binary> [baseline-file]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define TIMED_RUNS 3
+
+static const char *g_case;
+static const char *g_tool;
+
+static void die(const char *msg) {
+    fprintf(stderr, "benchbox: %s: %s\n", g_case ? g_case : "?", msg);
+    exit(99);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------ */
+/* Fixture directory                                                   */
+/* ------------------------------------------------------------------ */
+
+static char g_root[256];
+
+static int rm_cb(const char *path, const struct stat *st, int flag,
+                 struct FTW *ftw) {
+    (void)st; (void)ftw;
+    return (flag == FTW_DP || flag == FTW_D) ? rmdir(path) : unlink(path);
+}
+
+static void cleanup(void) {
+    if (g_root[0]) {
+        nftw(g_root, rm_cb, 32, FTW_DEPTH | FTW_PHYS);
+    }
+}
+
+static void make_root(void) {
+    const char *tmp = getenv("TMPDIR");
+    snprintf(g_root, sizeof(g_root), "%s/advbox-bench-XXXXXX",
+             tmp ? tmp : "/tmp");
+    if (!mkdtemp(g_root)) {
+        die("mkdtemp failed");
+    }
+    atexit(cleanup);
+}
+
+static char *root_path(const char *name) {
+    static char path[512];
+    snprintf(path, sizeof(path), "%s/%s", g_root, name);
+    return path;
+}
+
+static uint64_t file_bytes(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Workload generators                                                 */
+/* ------------------------------------------------------------------ */
+
+/* Tree of `dirs` directories with `files` small files each. */
+static uint64_t gen_tree(const char *name, int dirs, int files) {
+    char path[600];
+    if (mkdir(root_path(name), 0755) != 0) {
+        die("mkdir tree root failed");
+    }
+    for (int d = 0; d < dirs; d++) {
+        snprintf(path, sizeof(path), "%s/%s/d%04d", g_root, name, d);
+        if (mkdir(path, 0755) != 0) {
+            die("mkdir failed");
+        }
+        for (int f = 0; f < files; f++) {
+            snprintf(path, sizeof(path), "%s/%s/d%04d/f%04d",
+                     g_root, name, d, f);
+            int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+            if (fd < 0) {
+                die("create file failed");
+            }
+            if (write(fd, "advbox benchmark file\n", 22) != 22) {
+                die("write failed");
+            }
+            close(fd);
+        }
+    }
+    return (uint64_t)dirs * (uint64_t)files;
+}
+
+/* Representative calculator expressions, one per line. */
+static uint64_t gen_expressions(const char *name, long count) {
+    static const char *templates[] = {
+        "%ld + %ld * 3 - 7 / 2\n",
+        "sqrt(%ld) + sin(%ld) * cos(4)\n",
+        "(%ld + 2) * (%ld - 5) / 3.5\n",
+        "2 ^ 10 + %ld %% 17\n",
+        "log(%ld + 1) + exp(2) - abs(-%ld)\n",
+    };
+    FILE *f = fopen(root_path(name), "w");
+    if (!f) {
+        die("create corpus failed");
+    }
+    for (long i = 0; i < count; i++) {
+        fprintf(f, templates[i % 5], i + 1, i + 3);
+    }
+    fclose(f);
+    return (uint64_t)count;
+}
+
+/* Notes database in the on-disk record format, under a fake HOME. */
+static uint64_t gen_notes(long count) {
+    char path[600];
+    snprintf(path, sizeof(path), "%s/.notes", g_root);
+    if (mkdir(path, 0755) != 0) {
+        die("mkdir .notes failed");
+    }
+    snprintf(path, sizeof(path), "%s/.notes/notes.db", g_root);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        die("create notes.db failed");
+    }
+    for (long i = 1; i <= count; i++) {
+        /* every 100th note contains the search needle */
+        fprintf(f, "#%ld\n@2026-01-01 00:00:00\n*bench,tag%ld\n"
+                   "note body %ld with several words%s\n\n",
+                i, i % 7, i, i % 100 == 0 ? " flagged" : "");
+    }
+    fclose(f);
+    return (uint64_t)count;
+}
+
+/* Timestamp lines for the tzconvert/dateadd stream modes. */
+static uint64_t gen_timestamps(const char *name, long count, int with_time) {
+    FILE *f = fopen(root_path(name), "w");
+    if (!f) {
+        die("create timestamps failed");
+    }
+    for (long i = 0; i < count; i++) {
+        int year = 2000 + (int)(i % 30);
+        int month = 1 + (int)(i % 12);
+        int day = 1 + (int)(i % 28);
+        if (with_time) {
+            fprintf(f, "%04d-%02d-%02d %02d:%02d:%02d\n", year, month, day,
+                    (int)(i % 24), (int)(i % 60), (int)((i * 7) % 60));
+        } else {
+            fprintf(f, "%04d-%02d-%02d\n", year, month, day);
+        }
+    }
+    fclose(f);
+    return (uint64_t)count;
+}
+
+/* ------------------------------------------------------------------ */
+/* Child runner                                                        */
+/* ------------------------------------------------------------------ */
+
+/* Exec the tool with stdin from `input` (or /dev/null) and stdout and
+ * stderr discarded; returns wall time in ns. */
+static uint64_t run_tool(char *const argv[], const char *input) {
+    uint64_t start = now_ns();
+    pid_t pid = fork();
+    if (pid < 0) {
+        die("fork failed");
+    }
+    if (pid == 0) {
+        int in = open(input ? input : "/dev/null", O_RDONLY);
+        int out = open("/dev/null", O_WRONLY);
+        if (in < 0 || out < 0) {
+            _exit(97);
+        }
+        dup2(in, 0);
+        dup2(out, 1);
+        dup2(out, 2);
+        setenv("HOME", g_root, 1);
+        execv(argv[0], argv);
+        _exit(98);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        die("tool exited with an error");
+    }
+    return now_ns() - start;
+}
+
+static uint64_t best_of(char *const argv[], const char *input) {
+    run_tool(argv, input); /* warmup */
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < TIMED_RUNS; i++) {
+        uint64_t t = run_tool(argv, input);
+        if (t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+/* ------------------------------------------------------------------ */
+/* Baseline                                                            */
+/* ------------------------------------------------------------------ */
+
+/* Returns the ns/op threshold for the case, or 0 when absent. */
+static uint64_t baseline_threshold(const char *file, const char *name) {
+    if (!file) {
+        return 0;
+    }
+    FILE *f = fopen(file, "r");
+    if (!f) {
+        return 0;
+    }
+    char line[256];
+    uint64_t threshold = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char key[128];
+        unsigned long long value;
+        if (line[0] == '#' || sscanf(line, "%127s %llu", key, &value) != 2) {
+            continue;
+        }
+        if (strcmp(key, name) == 0) {
+            threshold = value;
+            break;
+        }
+    }
+    fclose(f);
+    return threshold;
+}
+
+/* ------------------------------------------------------------------ */
+/* Cases                                                               */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint64_t ops;
+    uint64_t bytes;
+    uint64_t wall_ns;
+} Result;
+
+static Result case_dirsize(long dirs, long files) {
+    Result r;
+    r.ops = gen_tree("tree", (int)dirs, (int)files);
+    r.bytes = r.ops * 22;
+    char *argv[] = {(char *)g_tool, "-s", root_path("tree"), NULL};
+    r.wall_ns = best_of(argv, NULL);
+    return r;
+}
+
+static Result case_calcx(long count) {
+    Result r;
+    r.ops = gen_expressions("corpus.txt", count);
+    r.bytes = file_bytes(root_path("corpus.txt"));
+    char *argv[] = {(char *)g_tool, "-", NULL};
+    r.wall_ns = best_of(argv, root_path("corpus.txt"));
+    return r;
+}
+
+static Result case_notes(long count, const char *verb, const char *arg) {
+    Result r;
+    r.ops = gen_notes(count);
+    char path[600];
+    snprintf(path, sizeof(path), "%s/.notes/notes.db", g_root);
+    r.bytes = file_bytes(path);
+    char *argv[] = {(char *)g_tool, (char *)verb, (char *)arg, NULL};
+    r.wall_ns = best_of(argv, NULL);
+    return r;
+}
+
+static Result case_tzconvert(long count) {
+    Result r;
+    r.ops = gen_timestamps("stamps.txt", count, 1);
+    r.bytes = file_bytes(root_path("stamps.txt"));
+    char *argv[] = {(char *)g_tool, "--stream", "UTC", "America/New_York",
+                    NULL};
+    r.wall_ns = best_of(argv, root_path("stamps.txt"));
+    return r;
+}
+
+static Result case_dateadd(long count) {
+    Result r;
+    r.ops = gen_timestamps("dates.txt", count, 0);
+    r.bytes = file_bytes(root_path("dates.txt"));
+    char *argv[] = {(char *)g_tool, "--stream", "+", "3", "d", NULL};
+    r.wall_ns = best_of(argv, root_path("dates.txt"));
+    return r;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: benchbox <case> <tool-binary> [baseline]\n");
+        return 99;
+    }
+    g_case = argv[1];
+    g_tool = argv[2];
+    const char *baseline = argc > 3 ? argv[3] : NULL;
+
+    make_root();
+
+    Result r;
+    if (strcmp(g_case, "dirsize-1k") == 0) {
+        r = case_dirsize(50, 20);
+    } else if (strcmp(g_case, "dirsize-10k") == 0) {
+        r = case_dirsize(200, 50);
+    } else if (strcmp(g_case, "dirsize-50k") == 0) {
+        r = case_dirsize(1000, 50);
+    } else if (strcmp(g_case, "calcx-eval") == 0) {
+        r = case_calcx(100000);
+    } else if (strcmp(g_case, "notes-load-10k") == 0) {
+        r = case_notes(10000, "list", "bench");
+    } else if (strcmp(g_case, "notes-load-100k") == 0) {
+        r = case_notes(100000, "list", "bench");
+    } else if (strcmp(g_case, "notes-search-100k") == 0) {
+        r = case_notes(100000, "search", "flagged");
+    } else if (strcmp(g_case, "tzconvert-stream") == 0) {
+        r = case_tzconvert(1000000);
+    } else if (strcmp(g_case, "dateadd-stream") == 0) {
+        r = case_dateadd(1000000);
+    } else {
+        die("unknown case");
+        return 99;
+    }
+
+    uint64_t ns_per_op = r.ops ? r.wall_ns / r.ops : 0;
+    uint64_t bytes_per_op = r.ops ? r.bytes / r.ops : 0;
+    uint64_t threshold = baseline_threshold(baseline, g_case);
+    const char *status = threshold == 0 ? "info"
+                       : ns_per_op <= threshold ? "ok" : "fail";
+
+    printf("ADVBOX-BENCH name=%s ops=%llu wall_ns=%llu ns_per_op=%llu "
+           "bytes_per_op=%llu status=%s\n",
+           g_case, (unsigned long long)r.ops, (unsigned long long)r.wall_ns,
+           (unsigned long long)ns_per_op, (unsigned long long)bytes_per_op,
+           status);
+    if (strcmp(status, "fail") == 0) {
+        fprintf(stderr, "benchbox: %s: %llu ns/op over baseline %llu ns/op\n",
+                g_case, (unsigned long long)ns_per_op,
+                (unsigned long long)threshold);
+        return 1;
+    }
+    return 0;
+}
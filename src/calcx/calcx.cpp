@@ -4,15 +4,23 @@
 #include <sstream>
 #include <cmath>
 #include <map>
-#include <stack>
+#include <unordered_map>
 #include <iomanip>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "advbox_core.hpp"
 
 const char* HELP = R"(
 Calculator - Command Line Calculator
 
 Usage:
     calc [expression]
+    calc -
     calc [-h|--help]
     calc [-m|--memory]
     calc [-c|--clear]
@@ -24,6 +32,23 @@ Options:
     -p, --precision Set decimal precision (default: 6)
     -b, --bin       Show result in binary
     -x, --hex       Show result in hexadecimal
+    --map EXPR      Evaluate EXPR over a numeric column (see below)
+
+Column mode:
+    calc --map EXPR [FILE]
+                    Read one number per line from FILE (or stdin),
+                    bind each to the variable 'x', and print one
+                    result per line. The expression is compiled once
+                    and executed over contiguous blocks of values,
+                    so large columns run at array speed. Division by
+                    zero yields inf/nan instead of aborting the run.
+
+Batch mode:
+    calc -          Read expressions from stdin, one per line.
+                    Lines of the form 'name = expr' bind a variable
+                    that later lines can use. Each expression is
+                    compiled once and the compiled form is reused
+                    when the same expression appears again.
 
 Operators:
     +  Addition
@@ -55,48 +80,95 @@ Example:
     calc 2 + 2
     calc sin(pi/2)
     calc "2^3 * 4"
+    seq 1000 | sed 's/.*/& * 2/' | calc -
+    calc --map "sqrt(x) * 2" column.txt
 )";
 
+// Expressions are compiled once into a flat postfix program and then
+// executed on a value stack. Compiling separates the per-expression
+// parse cost from the per-evaluation cost, which matters when one
+// process evaluates many lines (batch mode) or the same expression
+// repeatedly.
+enum class Op : uint8_t {
+    Const,   // push immediate value
+    Load,    // push variable slot
+    Add, Sub, Mul, Div, Mod, Pow,
+    Neg,     // unary minus
+    Call,    // single-argument function by table index
+};
+
+struct Instr {
+    Op op;
+    double value;  // Const
+    int index;     // Load slot / Call function index
+};
+
+struct Program {
+    std::vector<Instr> code;
+    int max_depth = 0;
+};
+
+// Block size for column mode: one operand slot of this many doubles
+// per stack level, so operator kernels run tight loops the compiler
+// can vectorize while the working set stays in cache.
+static const size_t MAP_BLOCK = 4096;
+
+struct Function {
+    const char* name;
+    double (*fn)(double);
+};
+
+static const Function FUNCTIONS[] = {
+    {"sqrt",  [](double x) { return std::sqrt(x); }},
+    {"sin",   [](double x) { return std::sin(x); }},
+    {"cos",   [](double x) { return std::cos(x); }},
+    {"tan",   [](double x) { return std::tan(x); }},
+    {"log",   [](double x) { return std::log(x); }},
+    {"exp",   [](double x) { return std::exp(x); }},
+    {"abs",   [](double x) { return std::fabs(x); }},
+    {"round", [](double x) { return std::round(x); }},
+    {"floor", [](double x) { return std::floor(x); }},
+    {"ceil",  [](double x) { return std::ceil(x); }},
+};
+static const int FUNCTION_COUNT = sizeof(FUNCTIONS) / sizeof(FUNCTIONS[0]);
+
 class Calculator {
 private:
-    std::map<std::string, double> variables;
+    // Variables live in a flat slot array so compiled programs can
+    // reference them by index; the map only resolves names to slots.
+    std::map<std::string, int> var_slots;
+    std::vector<double> var_values;
+    std::unordered_map<std::string, Program> compiled_cache;
+    std::vector<double> eval_stack;
     int precision;
     bool show_binary;
     bool show_hex;
 
-public:
-    Calculator() : precision(6), show_binary(false), show_hex(false) {
-        variables["pi"] = M_PI;
-        variables["e"] = M_E;
-        variables["ans"] = 0.0;
-    }
-
-    void set_precision(int p) {
-        if (p < 0 || p > 15) {
-            throw std::runtime_error("Precision must be between 0 and 15");
+    int slot(const std::string& name) {
+        auto it = var_slots.find(name);
+        if (it != var_slots.end()) {
+            return it->second;
         }
-        precision = p;
+        int idx = static_cast<int>(var_values.size());
+        var_slots[name] = idx;
+        var_values.push_back(0.0);
+        return idx;
     }
 
-    void set_binary(bool b) { show_binary = b; }
-    void set_hex(bool h) { show_hex = h; }
-
-    void clear_memory() {
-        variables.clear();
-        variables["pi"] = M_PI;
-        variables["e"] = M_E;
-        variables["ans"] = 0.0;
+    int find_slot(const std::string& name) const {
+        auto it = var_slots.find(name);
+        return it == var_slots.end() ? -1 : it->second;
     }
 
-    void show_memory() {
-        for (const auto& var : variables) {
-            std::cout << var.first << " = " << std::fixed 
-                     << std::setprecision(precision) << var.second << "\n";
+    static int find_function(const std::string& name) {
+        for (int f = 0; f < FUNCTION_COUNT; ++f) {
+            if (name == FUNCTIONS[f].name) return f;
         }
+        return -1;
     }
 
     bool is_operator(char c) {
-        return c == '+' || c == '-' || c == '*' || c == '/' || 
+        return c == '+' || c == '-' || c == '*' || c == '/' ||
                c == '^' || c == '%' || c == '(' || c == ')';
     }
 
@@ -105,44 +177,46 @@ public:
             case '+': case '-': return 1;
             case '*': case '/': case '%': return 2;
             case '^': return 3;
+            // Unary minus binds tighter than * and / but looser than ^,
+            // so -2^2 parses as -(2^2)
+            case 'n': return 2;
             default: return 0;
         }
     }
 
-    double apply_operator(double a, double b, char op) {
+    static Op binary_op(char op) {
         switch (op) {
-            case '+': return a + b;
-            case '-': return a - b;
-            case '*': return a * b;
-            case '/': 
-                if (b == 0) throw std::runtime_error("Division by zero");
-                return a / b;
-            case '%': 
-                if (b == 0) throw std::runtime_error("Modulo by zero");
-                return std::fmod(a, b);
-            case '^': return std::pow(a, b);
+            case '+': return Op::Add;
+            case '-': return Op::Sub;
+            case '*': return Op::Mul;
+            case '/': return Op::Div;
+            case '%': return Op::Mod;
+            case '^': return Op::Pow;
             default: throw std::runtime_error("Unknown operator");
         }
     }
 
-    double apply_function(const std::string& name, double arg) {
-        if (name == "sqrt") return std::sqrt(arg);
-        if (name == "sin") return std::sin(arg);
-        if (name == "cos") return std::cos(arg);
-        if (name == "tan") return std::tan(arg);
-        if (name == "log") return std::log(arg);
-        if (name == "exp") return std::exp(arg);
-        if (name == "abs") return std::abs(arg);
-        if (name == "round") return std::round(arg);
-        if (name == "floor") return std::floor(arg);
-        if (name == "ceil") return std::ceil(arg);
-        throw std::runtime_error("Unknown function: " + name);
+    // Pending operator-stack entries: single chars for operators and
+    // '(' markers, 'n' for unary minus, or a function call tagged with
+    // its table index.
+    struct PendingOp {
+        char op;
+        int func;
+    };
+
+    void emit_pending(Program& prog, const PendingOp& p) {
+        if (p.func >= 0) {
+            prog.code.push_back({Op::Call, 0.0, p.func});
+        } else if (p.op == 'n') {
+            prog.code.push_back({Op::Neg, 0.0, 0});
+        } else {
+            prog.code.push_back({binary_op(p.op), 0.0, 0});
+        }
     }
 
-    double evaluate(const std::string& expr) {
-        std::stack<double> values;
-        std::stack<char> ops;
-        std::string token;
+    Program compile(const std::string& expr) {
+        Program prog;
+        std::vector<PendingOp> ops;
         bool expect_operator = false;
 
         for (size_t i = 0; i < expr.length(); ++i) {
@@ -151,85 +225,74 @@ public:
             if (std::isspace(c)) continue;
 
             if (std::isdigit(c) || c == '.') {
-                token = "";
+                std::string token;
                 while (i < expr.length() && (std::isdigit(expr[i]) || expr[i] == '.')) {
                     token += expr[i++];
                 }
                 --i;
-                values.push(std::stod(token));
+                prog.code.push_back({Op::Const, advbox::to_double(token, "number"), 0});
                 expect_operator = true;
             }
             else if (std::isalpha(c)) {
-                token = "";
+                std::string token;
                 while (i < expr.length() && std::isalnum(expr[i])) {
                     token += expr[i++];
                 }
                 --i;
 
-                if (variables.find(token) != variables.end()) {
-                    values.push(variables[token]);
+                int var = find_slot(token);
+                if (var >= 0) {
+                    prog.code.push_back({Op::Load, 0.0, var});
                     expect_operator = true;
                 }
                 else {
-                    // It is a function call
-                    while (i < expr.length() && std::isspace(expr[i])) ++i;
-                    if (i >= expr.length() || expr[i] != '(') {
-                        throw std::runtime_error("Expected '(' after function name");
+                    int func = find_function(token);
+                    if (func < 0) {
+                        throw std::runtime_error("Unknown function: " + token);
                     }
-
-                    int brackets = 1;
-                    std::string arg_expr;
-                    ++i;
-                    while (i < expr.length() && brackets > 0) {
-                        if (expr[i] == '(') ++brackets;
-                        else if (expr[i] == ')') --brackets;
-                        if (brackets > 0) arg_expr += expr[i];
-                        ++i;
-                    }
-                    if (brackets > 0) {
-                        throw std::runtime_error("Missing closing parenthesis");
+                    size_t j = i + 1;
+                    while (j < expr.length() && std::isspace(expr[j])) ++j;
+                    if (j >= expr.length() || expr[j] != '(') {
+                        throw std::runtime_error("Expected '(' after function name");
                     }
-                    --i;
-
-                    double arg = evaluate(arg_expr);
-                    values.push(apply_function(token, arg));
-                    expect_operator = true;
+                    i = j;
+                    ops.push_back({'(', func});
+                    expect_operator = false;
                 }
             }
             else if (is_operator(c)) {
                 if (c == '-' && !expect_operator) {
-                    values.push(0.0); // Unary minus
+                    ops.push_back({'n', -1});
                 }
                 else if (!expect_operator && c != '(') {
                     throw std::runtime_error("Unexpected operator");
                 }
-
-                if (c == '(') {
-                    ops.push(c);
+                else if (c == '(') {
+                    ops.push_back({'(', -1});
                     expect_operator = false;
                 }
                 else if (c == ')') {
-                    while (!ops.empty() && ops.top() != '(') {
-                        double b = values.top(); values.pop();
-                        double a = values.top(); values.pop();
-                        values.push(apply_operator(a, b, ops.top()));
-                        ops.pop();
+                    while (!ops.empty() && ops.back().op != '(') {
+                        emit_pending(prog, ops.back());
+                        ops.pop_back();
                     }
                     if (ops.empty()) {
                         throw std::runtime_error("Mismatched parentheses");
                     }
-                    ops.pop(); // Remove '('
+                    // A '(' tagged with a function index is a call site.
+                    if (ops.back().func >= 0) {
+                        prog.code.push_back({Op::Call, 0.0, ops.back().func});
+                    }
+                    ops.pop_back();
                     expect_operator = true;
                 }
                 else {
-                    while (!ops.empty() && ops.top() != '(' && 
-                           get_precedence(ops.top()) >= get_precedence(c)) {
-                        double b = values.top(); values.pop();
-                        double a = values.top(); values.pop();
-                        values.push(apply_operator(a, b, ops.top()));
-                        ops.pop();
+                    while (!ops.empty() && ops.back().op != '(' &&
+                           get_precedence(ops.back().op) >= get_precedence(c)) {
+                        emit_pending(prog, ops.back());
+                        ops.pop_back();
                     }
-                    ops.push(c);
+                    ops.push_back({c, -1});
                     expect_operator = false;
                 }
             }
@@ -239,24 +302,224 @@ public:
         }
 
         while (!ops.empty()) {
-            if (ops.top() == '(') {
+            if (ops.back().op == '(') {
                 throw std::runtime_error("Mismatched parentheses");
             }
-            double b = values.top(); values.pop();
-            double a = values.top(); values.pop();
-            values.push(apply_operator(a, b, ops.top()));
-            ops.pop();
+            emit_pending(prog, ops.back());
+            ops.pop_back();
+        }
+
+        // Validate stack balance once at compile time so the run loop
+        // can skip per-instruction underflow checks.
+        int depth = 0;
+        for (const auto& in : prog.code) {
+            switch (in.op) {
+                case Op::Const: case Op::Load:
+                    if (++depth > prog.max_depth) prog.max_depth = depth;
+                    break;
+                case Op::Neg: case Op::Call:
+                    if (depth < 1) throw std::runtime_error("Malformed expression");
+                    break;
+                default:
+                    if (depth < 2) throw std::runtime_error("Malformed expression");
+                    --depth;
+                    break;
+            }
+        }
+        if (depth != 1) {
+            throw std::runtime_error(depth == 0 ? "Empty expression"
+                                                : "Malformed expression");
         }
 
-        if (values.empty()) {
-            throw std::runtime_error("Empty expression");
+        return prog;
+    }
+
+    double run(const Program& prog) {
+        eval_stack.clear();
+        for (const auto& in : prog.code) {
+            switch (in.op) {
+                case Op::Const:
+                    eval_stack.push_back(in.value);
+                    break;
+                case Op::Load:
+                    eval_stack.push_back(var_values[in.index]);
+                    break;
+                case Op::Neg:
+                    eval_stack.back() = -eval_stack.back();
+                    break;
+                case Op::Call:
+                    eval_stack.back() = FUNCTIONS[in.index].fn(eval_stack.back());
+                    break;
+                default: {
+                    double b = eval_stack.back();
+                    eval_stack.pop_back();
+                    double& a = eval_stack.back();
+                    switch (in.op) {
+                        case Op::Add: a += b; break;
+                        case Op::Sub: a -= b; break;
+                        case Op::Mul: a *= b; break;
+                        case Op::Div:
+                            if (b == 0) throw std::runtime_error("Division by zero");
+                            a /= b;
+                            break;
+                        case Op::Mod:
+                            if (b == 0) throw std::runtime_error("Modulo by zero");
+                            a = std::fmod(a, b);
+                            break;
+                        case Op::Pow:
+                            a = std::pow(a, b);
+                            break;
+                        default:
+                            throw std::runtime_error("Unknown operator");
+                    }
+                    break;
+                }
+            }
         }
+        return eval_stack.back();
+    }
+
+    // Run the program over a block of n column values at once. Every
+    // stack level is a contiguous slot of MAP_BLOCK doubles and each
+    // opcode is a loop over the block, so the arithmetic kernels
+    // auto-vectorize. Unlike the scalar path, division and modulo
+    // follow IEEE semantics (inf/nan) instead of throwing, so one bad
+    // row cannot abort a long run.
+    void run_block(const Program& prog, const double* in, size_t n,
+                   double* stack, int x_slot) {
+        double* sp = stack;
+        for (const auto& instr : prog.code) {
+            switch (instr.op) {
+                case Op::Const:
+                    std::fill(sp, sp + n, instr.value);
+                    sp += MAP_BLOCK;
+                    break;
+                case Op::Load:
+                    if (instr.index == x_slot) {
+                        std::copy(in, in + n, sp);
+                    } else {
+                        std::fill(sp, sp + n, var_values[instr.index]);
+                    }
+                    sp += MAP_BLOCK;
+                    break;
+                case Op::Neg: {
+                    double* a = sp - MAP_BLOCK;
+                    for (size_t k = 0; k < n; ++k) a[k] = -a[k];
+                    break;
+                }
+                case Op::Call: {
+                    double* a = sp - MAP_BLOCK;
+                    double (*fn)(double) = FUNCTIONS[instr.index].fn;
+                    for (size_t k = 0; k < n; ++k) a[k] = fn(a[k]);
+                    break;
+                }
+                default: {
+                    double* b = sp - MAP_BLOCK;
+                    double* a = sp - 2 * MAP_BLOCK;
+                    switch (instr.op) {
+                        case Op::Add:
+                            for (size_t k = 0; k < n; ++k) a[k] += b[k];
+                            break;
+                        case Op::Sub:
+                            for (size_t k = 0; k < n; ++k) a[k] -= b[k];
+                            break;
+                        case Op::Mul:
+                            for (size_t k = 0; k < n; ++k) a[k] *= b[k];
+                            break;
+                        case Op::Div:
+                            for (size_t k = 0; k < n; ++k) a[k] /= b[k];
+                            break;
+                        case Op::Mod:
+                            for (size_t k = 0; k < n; ++k) a[k] = std::fmod(a[k], b[k]);
+                            break;
+                        case Op::Pow:
+                            for (size_t k = 0; k < n; ++k) a[k] = std::pow(a[k], b[k]);
+                            break;
+                        default:
+                            throw std::runtime_error("Unknown operator");
+                    }
+                    sp -= MAP_BLOCK;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Worst case for "%.*f": DBL_MAX has 309 integer digits, plus sign,
+    // decimal point, 15 fraction digits, newline and terminator.
+    static constexpr size_t PRINT_ENTRY_MAX = 336;
+
+    void print_block(const double* values, size_t n, char* obuf,
+                     size_t obuf_cap, size_t& olen) {
+        for (size_t k = 0; k < n; ++k) {
+            if (olen + PRINT_ENTRY_MAX > obuf_cap) {
+                fwrite(obuf, 1, olen, stdout);
+                olen = 0;
+            }
+            olen += snprintf(obuf + olen, PRINT_ENTRY_MAX, "%.*f\n",
+                             precision, values[k]);
+        }
+    }
+
+    const Program& compiled(const std::string& expr) {
+        auto it = compiled_cache.find(expr);
+        if (it != compiled_cache.end()) {
+            return it->second;
+        }
+        return compiled_cache.emplace(expr, compile(expr)).first->second;
+    }
 
-        double result = values.top();
-        variables["ans"] = result;
+    void set_defaults() {
+        var_values[slot("pi")] = M_PI;
+        var_values[slot("e")] = M_E;
+        var_values[slot("ans")] = 0.0;
+    }
+
+public:
+    Calculator() : precision(6), show_binary(false), show_hex(false) {
+        set_defaults();
+    }
+
+    void set_precision(int p) {
+        if (p < 0 || p > 15) {
+            throw std::runtime_error("Precision must be between 0 and 15");
+        }
+        precision = p;
+    }
+
+    void set_binary(bool b) { show_binary = b; }
+    void set_hex(bool h) { show_hex = h; }
+
+    void clear_memory() {
+        var_slots.clear();
+        var_values.clear();
+        compiled_cache.clear();
+        set_defaults();
+    }
+
+    void show_memory() {
+        for (const auto& var : var_slots) {
+            std::cout << var.first << " = " << std::fixed
+                     << std::setprecision(precision) << var_values[var.second] << "\n";
+        }
+    }
+
+    double evaluate(const std::string& expr) {
+        double result = run(compiled(expr));
+        var_values[slot("ans")] = result;
         return result;
     }
 
+    void set_variable(const std::string& name, double value) {
+        if (find_function(name) >= 0) {
+            throw std::runtime_error("Cannot redefine function: " + name);
+        }
+        var_values[slot(name)] = value;
+        // Expressions compiled before the name existed resolved it
+        // differently (or failed); drop them so they recompile.
+        compiled_cache.clear();
+    }
+
     void print_result(double result) {
         if (show_binary) {
             std::cout << "Binary: 0b";
@@ -273,29 +536,148 @@ public:
             }
             std::cout << "\n";
         }
-        
+
         if (show_hex) {
-            std::cout << "Hex: 0x" << std::hex << std::uppercase 
+            std::cout << "Hex: 0x" << std::hex << std::uppercase
                      << static_cast<int64_t>(result) << std::dec << "\n";
         }
 
         std::cout << std::fixed << std::setprecision(precision) << result << "\n";
     }
+
+    // Column mode: parse one number per line from f, bind each to the
+    // variable 'x', and stream results. Input is consumed in large
+    // reads and parsed in place; values are batched into MAP_BLOCK
+    // chunks and evaluated with run_block, so throughput is bounded
+    // by parsing and memory bandwidth rather than interpreter speed.
+    int run_map(const std::string& expr, FILE* f) {
+        int x_slot = slot("x");
+        const Program& prog = compiled(expr);
+
+        std::vector<double> stack_buf(static_cast<size_t>(prog.max_depth) * MAP_BLOCK);
+        std::vector<double> input(MAP_BLOCK);
+        size_t filled = 0;
+
+        std::vector<char> rbuf(1 << 20);
+        std::vector<char> obuf(1 << 16);
+        size_t carry = 0, olen = 0;
+        size_t line = 1;
+        bool eof = false;
+
+        while (!eof || carry > 0) {
+            size_t got = 0;
+            if (!eof) {
+                size_t space = rbuf.size() - carry - 1;
+                if (space == 0) {
+                    throw std::runtime_error("Number too long on line "
+                                             + std::to_string(line));
+                }
+                got = fread(rbuf.data() + carry, 1, space, f);
+                if (got < space) eof = true;
+            }
+            size_t have = carry + got;
+            rbuf[have] = '\0';
+
+            char* p = rbuf.data();
+            char* end = rbuf.data() + have;
+            while (p < end) {
+                char* q;
+                double v = strtod(p, &q);
+                if (q == p) {
+                    // No digits: either trailing whitespace or junk.
+                    while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+                        if (*p == '\n') ++line;
+                        ++p;
+                    }
+                    if (p == end) break;
+                    throw std::runtime_error("Invalid number on line "
+                                             + std::to_string(line));
+                }
+                if (q == end && !eof) {
+                    // The token may continue in the next read.
+                    break;
+                }
+                for (char* s = p; s < q; ++s) {
+                    if (*s == '\n') ++line;
+                }
+                p = q;
+                input[filled++] = v;
+                if (filled == MAP_BLOCK) {
+                    run_block(prog, input.data(), filled, stack_buf.data(), x_slot);
+                    print_block(stack_buf.data(), filled, obuf.data(),
+                                obuf.size(), olen);
+                    filled = 0;
+                }
+            }
+            carry = end - p;
+            memmove(rbuf.data(), p, carry);
+            if (eof) carry = 0;
+        }
+
+        if (filled > 0) {
+            run_block(prog, input.data(), filled, stack_buf.data(), x_slot);
+            print_block(stack_buf.data(), filled, obuf.data(), obuf.size(), olen);
+        }
+        if (olen > 0) {
+            fwrite(obuf.data(), 1, olen, stdout);
+        }
+        return 0;
+    }
+
+    // Batch/REPL mode: one expression or 'name = expr' binding per
+    // line. The compiled-program cache and the variable slots persist
+    // across lines, so repeated expressions parse exactly once.
+    int run_stream(std::istream& in) {
+        bool interactive = isatty(fileno(stdin));
+        int failures = 0;
+        std::string line;
+
+        if (interactive) std::cout << "calc> " << std::flush;
+        while (std::getline(in, line)) {
+            try {
+                size_t start = line.find_first_not_of(" \t");
+                if (start != std::string::npos && line[start] != '#') {
+                    std::string name;
+                    size_t p = start;
+                    if (std::isalpha(line[p])) {
+                        while (p < line.length() && std::isalnum(line[p])) {
+                            name += line[p++];
+                        }
+                        while (p < line.length() && std::isspace(line[p])) ++p;
+                    }
+                    if (!name.empty() && p < line.length() && line[p] == '=') {
+                        set_variable(name, evaluate(line.substr(p + 1)));
+                    } else {
+                        print_result(evaluate(line.substr(start)));
+                    }
+                }
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+                ++failures;
+            }
+            if (interactive) std::cout << "calc> " << std::flush;
+        }
+        if (interactive) std::cout << "\n";
+        return failures > 0 ? 1 : 0;
+    }
 };
 
 int main(int argc, char* argv[]) {
     try {
         std::vector<std::string> args(argv + 1, argv + argc);
-        
+
         if (args.empty() || args[0] == "-h" || args[0] == "--help") {
             std::cout << HELP;
             return 0;
         }
 
         Calculator calc;
+        std::string map_expr;
+        bool map_mode = false;
 
         size_t i = 0;
-        while (i < args.size() && args[i][0] == '-') {
+        while (i < args.size() && args[i][0] == '-' && args[i] != "-") {
             if (args[i] == "-m" || args[i] == "--memory") {
                 calc.show_memory();
                 return 0;
@@ -309,7 +691,7 @@ int main(int argc, char* argv[]) {
                 if (++i >= args.size()) {
                     throw std::runtime_error("Precision value required");
                 }
-                calc.set_precision(std::stoi(args[i]));
+                calc.set_precision(static_cast<int>(advbox::to_i64(args[i], "precision")));
             }
             else if (args[i] == "-b" || args[i] == "--bin") {
                 calc.set_binary(true);
@@ -317,12 +699,36 @@ int main(int argc, char* argv[]) {
             else if (args[i] == "-x" || args[i] == "--hex") {
                 calc.set_hex(true);
             }
+            else if (args[i] == "--map") {
+                if (++i >= args.size()) {
+                    throw std::runtime_error("Expression required after --map");
+                }
+                map_expr = args[i];
+                map_mode = true;
+            }
             else {
                 throw std::runtime_error("Unknown option: " + args[i]);
             }
             i++;
         }
 
+        if (map_mode) {
+            FILE* f = stdin;
+            if (i < args.size() && args[i] != "-") {
+                f = fopen(args[i].c_str(), "r");
+                if (!f) {
+                    throw std::runtime_error("Cannot open file: " + args[i]);
+                }
+            }
+            int rc = calc.run_map(map_expr, f);
+            if (f != stdin) fclose(f);
+            return rc;
+        }
+
+        if (i < args.size() && args[i] == "-") {
+            return calc.run_stream(std::cin);
+        }
+
         std::string expr;
         for (; i < args.size(); i++) {
             if (!expr.empty()) expr += " ";
@@ -335,7 +741,7 @@ int main(int argc, char* argv[]) {
 
         double result = calc.evaluate(expr);
         calc.print_result(result);
-        
+
         return 0;
     }
     catch (const std::exception& e) {
@@ -343,4 +749,4 @@ int main(int argc, char* argv[]) {
         std::cerr << "Try 'calc --help' for more information.\n";
         return 1;
     }
-}
\ No newline at end of file
+}
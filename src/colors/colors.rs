@@ -1,4 +1,4 @@
-use std::io::{self, Write};
+use std::io::{self, Read, Write};
 use std::env;
 use std::process;
 
@@ -15,12 +15,19 @@ Options:
     -r, --rgb       Show RGB color examples
     -f, --format    Show text formatting options
     -t, --test     'Hello World' in different styles
+    -c, --convert FROM:TO <value|->
+                    Convert color values; '-' reads one value per
+                    line from stdin. FROM is hex or rgb, TO is hex,
+                    rgb or ansi (nearest 256-color index).
+                    hex looks like '#RRGGBB', rgb like 'R,G,B'.
     -h, --help      Show this help message
 
 Example:
     colors -b -f    Show basic colors and formatting
     colors -2       Show 256 color palette
     colors --test   Show test patterns
+    colors -c hex:rgb '#ff8800'
+    colors -c rgb:ansi - < theme_colors.txt
 ";
 
 struct Config {
@@ -30,6 +37,8 @@ struct Config {
     show_rgb: bool,
     show_format: bool,
     show_test: bool,
+    convert: Option<(Format, Format)>,
+    convert_value: Option<String>,
 }
 
 impl Default for Config {
@@ -41,6 +50,8 @@ impl Default for Config {
             show_rgb: false,
             show_format: false,
             show_test: false,
+            convert: None,
+            convert_value: None,
         }
     }
 }
@@ -201,6 +212,290 @@ fn show_test_patterns() {
     println!("Yellow on Red:   \x1b[33;41m{}\x1b[0m", text);
 }
 
+// ---------------------------------------------------------------------------
+// Conversion engine
+//
+// Built for bulk use: the stream mode runs every line through the same
+// table-driven kernels as the single-value mode, with fixed buffers on
+// both sides — chunked reads, in-place parsing, one big buffered write.
+// All per-character work goes through 256-entry lookup tables so the
+// inner loop is branch-light and allocation-free.
+// ---------------------------------------------------------------------------
+
+#[derive(Clone, Copy, PartialEq)]
+enum Format {
+    Hex,
+    Rgb,
+    Ansi, // nearest xterm-256 palette index
+}
+
+const STREAM_BUF: usize = 1 << 16;
+const OUT_FLUSH: usize = 1 << 20;
+
+// Tables are built once at startup; const fns would do the same job
+// but read worse for the distance table.
+struct Tables {
+    hex_val: [i8; 256],     // ascii -> nibble value, -1 for non-hex
+    hex_pair: [[u8; 2]; 256], // byte -> two lowercase hex digits
+    cube_idx: [u8; 256],    // channel value -> nearest 6x6x6 cube level
+}
+
+const CUBE_LEVELS: [u8; 6] = [0, 95, 135, 175, 215, 255];
+
+fn build_tables() -> Tables {
+    let mut hex_val = [-1i8; 256];
+    for (i, c) in b"0123456789".iter().enumerate() {
+        hex_val[*c as usize] = i as i8;
+    }
+    for (i, c) in b"abcdef".iter().enumerate() {
+        hex_val[*c as usize] = 10 + i as i8;
+        hex_val[c.to_ascii_uppercase() as usize] = 10 + i as i8;
+    }
+
+    let digits = b"0123456789abcdef";
+    let mut hex_pair = [[0u8; 2]; 256];
+    for i in 0..256 {
+        hex_pair[i] = [digits[i >> 4], digits[i & 0xf]];
+    }
+
+    let mut cube_idx = [0u8; 256];
+    for v in 0..256 {
+        let mut best = 0;
+        let mut best_dist = i32::MAX;
+        for (i, &level) in CUBE_LEVELS.iter().enumerate() {
+            let d = (v as i32 - level as i32).abs();
+            if d < best_dist {
+                best_dist = d;
+                best = i;
+            }
+        }
+        cube_idx[v] = best as u8;
+    }
+
+    Tables { hex_val, hex_pair, cube_idx }
+}
+
+// '#RRGGBB' or 'RRGGBB'.
+fn parse_hex(s: &[u8], t: &Tables) -> Option<(u8, u8, u8)> {
+    let s = if s.first() == Some(&b'#') { &s[1..] } else { s };
+    if s.len() != 6 {
+        return None;
+    }
+    let mut nibbles = [0u8; 6];
+    for i in 0..6 {
+        let v = t.hex_val[s[i] as usize];
+        if v < 0 {
+            return None;
+        }
+        nibbles[i] = v as u8;
+    }
+    Some((
+        nibbles[0] << 4 | nibbles[1],
+        nibbles[2] << 4 | nibbles[3],
+        nibbles[4] << 4 | nibbles[5],
+    ))
+}
+
+// 'R,G,B' with optional spaces after the commas.
+fn parse_rgb(s: &[u8]) -> Option<(u8, u8, u8)> {
+    let mut channels = [0u16; 3];
+    let mut chan = 0;
+    let mut digits = 0;
+    let mut i = 0;
+    while i < s.len() {
+        let c = s[i];
+        if c.is_ascii_digit() {
+            channels[chan] = channels[chan] * 10 + (c - b'0') as u16;
+            if channels[chan] > 255 {
+                return None;
+            }
+            digits += 1;
+        } else if c == b',' {
+            if digits == 0 || chan == 2 {
+                return None;
+            }
+            chan += 1;
+            digits = 0;
+            if i + 1 < s.len() && s[i + 1] == b' ' {
+                i += 1;
+            }
+        } else {
+            return None;
+        }
+        i += 1;
+    }
+    if chan != 2 || digits == 0 {
+        return None;
+    }
+    Some((channels[0] as u8, channels[1] as u8, channels[2] as u8))
+}
+
+// Nearest xterm-256 index: best of the 6x6x6 cube candidate and the
+// 24-step grayscale ramp candidate, by squared RGB distance.
+fn nearest_ansi(r: u8, g: u8, b: u8, t: &Tables) -> u8 {
+    let (ci, cj, ck) = (t.cube_idx[r as usize], t.cube_idx[g as usize], t.cube_idx[b as usize]);
+    let (cr, cg, cb) = (CUBE_LEVELS[ci as usize], CUBE_LEVELS[cj as usize], CUBE_LEVELS[ck as usize]);
+    let dist = |x: u8, y: u8| {
+        let d = x as i32 - y as i32;
+        d * d
+    };
+    let cube_dist = dist(r, cr) + dist(g, cg) + dist(b, cb);
+
+    // Grayscale ramp: 232 + n holds value 8 + 10n for n in 0..24.
+    let avg = (r as i32 + g as i32 + b as i32) / 3;
+    let gray_n = ((avg - 8 + 5) / 10).max(0).min(23);
+    let gray = (8 + 10 * gray_n) as u8;
+    let gray_dist = dist(r, gray) + dist(g, gray) + dist(b, gray);
+
+    if gray_dist < cube_dist {
+        232 + gray_n as u8
+    } else {
+        16 + 36 * ci + 6 * cj + ck
+    }
+}
+
+fn push_dec(out: &mut Vec<u8>, v: u8) {
+    if v >= 100 {
+        out.push(b'0' + v / 100);
+    }
+    if v >= 10 {
+        out.push(b'0' + v / 10 % 10);
+    }
+    out.push(b'0' + v % 10);
+}
+
+// Parse one value and append its conversion; the single-value CLI path
+// is a thin wrapper over this same kernel.
+fn convert_one(s: &[u8], from: Format, to: Format, t: &Tables, out: &mut Vec<u8>) -> bool {
+    let (r, g, b) = match from {
+        Format::Hex => match parse_hex(s, t) {
+            Some(c) => c,
+            None => return false,
+        },
+        Format::Rgb => match parse_rgb(s) {
+            Some(c) => c,
+            None => return false,
+        },
+        Format::Ansi => return false, // input format, not supported
+    };
+    match to {
+        Format::Hex => {
+            out.push(b'#');
+            out.extend_from_slice(&t.hex_pair[r as usize]);
+            out.extend_from_slice(&t.hex_pair[g as usize]);
+            out.extend_from_slice(&t.hex_pair[b as usize]);
+        }
+        Format::Rgb => {
+            push_dec(out, r);
+            out.push(b',');
+            push_dec(out, g);
+            out.push(b',');
+            push_dec(out, b);
+        }
+        Format::Ansi => push_dec(out, nearest_ansi(r, g, b, t)),
+    }
+    out.push(b'\n');
+    true
+}
+
+// One value per stdin line; partial lines carry over between chunks,
+// output is flushed in megabyte batches.
+fn run_convert_stream(from: Format, to: Format, t: &Tables) -> i32 {
+    let mut stdin = io::stdin();
+    let stdout = io::stdout();
+    let mut stdout = stdout.lock();
+    let mut buf = vec![0u8; STREAM_BUF];
+    let mut carry: Vec<u8> = Vec::new();
+    let mut out: Vec<u8> = Vec::with_capacity(OUT_FLUSH + 64);
+    let mut line_no: u64 = 0;
+
+    loop {
+        let n = match stdin.read(&mut buf) {
+            Ok(n) => n,
+            Err(e) => {
+                eprintln!("Error reading stdin: {}", e);
+                return 1;
+            }
+        };
+        let eof = n == 0;
+        let chunk = &buf[..n];
+        let mut start = 0;
+        while let Some(pos) = chunk[start..].iter().position(|&c| c == b'\n') {
+            let mut line: &[u8] = &chunk[start..start + pos];
+            start += pos + 1;
+            line_no += 1;
+            if !carry.is_empty() {
+                carry.extend_from_slice(line);
+                line = &[];
+            }
+            let full: &[u8] = if carry.is_empty() { line } else { &carry };
+            let full = match full.last() {
+                Some(b'\r') => &full[..full.len() - 1],
+                _ => full,
+            };
+            if !full.is_empty() && !convert_one(full, from, to, t, &mut out) {
+                // Keep the results for the lines before the bad one
+                let _ = stdout.write_all(&out).and_then(|_| stdout.flush());
+                eprintln!("Error: Invalid value on line {}", line_no);
+                return 1;
+            }
+            carry.clear();
+        }
+        carry.extend_from_slice(&chunk[start..]);
+
+        if eof {
+            if !carry.is_empty() {
+                line_no += 1;
+                let full: Vec<u8> = std::mem::take(&mut carry);
+                let full = match full.last() {
+                    Some(b'\r') => &full[..full.len() - 1],
+                    _ => &full[..],
+                };
+                if !full.is_empty() && !convert_one(full, from, to, t, &mut out) {
+                    let _ = stdout.write_all(&out).and_then(|_| stdout.flush());
+                    eprintln!("Error: Invalid value on line {}", line_no);
+                    return 1;
+                }
+            }
+            break;
+        }
+        if out.len() >= OUT_FLUSH {
+            if stdout.write_all(&out).is_err() {
+                return 0; // consumer went away
+            }
+            out.clear();
+        }
+    }
+
+    if stdout.write_all(&out).is_err() || stdout.flush().is_err() {
+        return 0;
+    }
+    0
+}
+
+fn parse_format(s: &str) -> Option<Format> {
+    match s {
+        "hex" => Some(Format::Hex),
+        "rgb" => Some(Format::Rgb),
+        "ansi" | "256" => Some(Format::Ansi),
+        _ => None,
+    }
+}
+
+fn run_convert(from: Format, to: Format, value: &str) -> i32 {
+    let tables = build_tables();
+    if value == "-" {
+        return run_convert_stream(from, to, &tables);
+    }
+    let mut out = Vec::with_capacity(16);
+    if !convert_one(value.as_bytes(), from, to, &tables, &mut out) {
+        eprintln!("Error: Invalid value: {}", value);
+        return 1;
+    }
+    let _ = io::stdout().write_all(&out);
+    0
+}
+
 fn parse_args() -> Config {
     let args: Vec<String> = env::args().collect();
     let mut config = Config::default();
@@ -213,32 +508,62 @@ fn parse_args() -> Config {
         return config;
     }
     
-    for arg in args.iter().skip(1) {
-        match arg.as_str() {
+    let mut i = 1;
+    while i < args.len() {
+        match args[i].as_str() {
             "-b" | "--basic" => config.show_basic = true,
             "-e" | "--extended" => config.show_extended = true,
             "-2" | "--256" => config.show_256 = true,
             "-r" | "--rgb" => config.show_rgb = true,
             "-f" | "--format" => config.show_format = true,
             "-t" | "--test" => config.show_test = true,
+            "-c" | "--convert" => {
+                if i + 2 >= args.len() {
+                    eprintln!("Error: --convert needs FROM:TO and a value (or '-')");
+                    eprintln!("Try 'colors --help' for more information.");
+                    process::exit(1);
+                }
+                let spec = &args[i + 1];
+                let mut parts = spec.splitn(2, ':');
+                let from = parts.next().and_then(parse_format);
+                let to = parts.next().and_then(parse_format);
+                match (from, to) {
+                    (Some(from), Some(to)) if from != Format::Ansi => {
+                        config.convert = Some((from, to));
+                    }
+                    _ => {
+                        eprintln!("Error: Invalid conversion: {}", spec);
+                        eprintln!("Supported: hex:rgb, hex:ansi, rgb:hex, rgb:ansi");
+                        process::exit(1);
+                    }
+                }
+                config.convert_value = Some(args[i + 2].clone());
+                i += 2;
+            }
             "-h" | "--help" => {
                 println!("{}", HELP);
                 process::exit(0);
             }
-            _ => {
-                eprintln!("Unknown option: {}", arg);
+            other => {
+                eprintln!("Unknown option: {}", other);
                 eprintln!("Try 'colors --help' for more information.");
                 process::exit(1);
             }
         }
+        i += 1;
     }
-    
+
     config
 }
 
 fn main() {
     let config = parse_args();
-    
+
+    if let Some((from, to)) = config.convert {
+        let value = config.convert_value.as_deref().unwrap_or("-");
+        process::exit(run_convert(from, to, value));
+    }
+
     if config.show_basic {
         show_basic_colors();
     }
@@ -0,0 +1,250 @@
+#include "advbox_core.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace advbox {
+
+// ---------------------------------------------------------------------------
+// Arena
+// ---------------------------------------------------------------------------
+
+Arena::Arena(size_t block_size) : block_size_(block_size) {}
+
+Arena::~Arena() {
+    for (const Block& block : blocks_) {
+        delete[] block.data;
+    }
+}
+
+void* Arena::alloc(size_t size, size_t align) {
+    uintptr_t p = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(align - 1);
+    if (cur_ == nullptr || p + size > reinterpret_cast<uintptr_t>(end_)) {
+        // Move to the next retained block, or grow. Oversized requests
+        // get a dedicated block so they never thrash the chain.
+        size_t want = size + align > block_size_ ? size + align : block_size_;
+        size_t next = cur_ == nullptr ? 0 : active_ + 1;
+        while (next < blocks_.size() && blocks_[next].size < want) {
+            next++;
+        }
+        if (next == blocks_.size()) {
+            blocks_.push_back(Block{new char[want], want});
+        }
+        active_ = next;
+        cur_ = blocks_[active_].data;
+        end_ = cur_ + blocks_[active_].size;
+        p = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(align - 1);
+    }
+    cur_ = reinterpret_cast<char*>(p + size);
+    return reinterpret_cast<void*>(p);
+}
+
+std::string_view Arena::copy(std::string_view s) {
+    char* p = static_cast<char*>(alloc(s.size() + 1, 1));
+    std::memcpy(p, s.data(), s.size());
+    p[s.size()] = '\0';
+    return std::string_view(p, s.size());
+}
+
+void Arena::reset() {
+    active_ = 0;
+    if (blocks_.empty()) {
+        cur_ = end_ = nullptr;
+    } else {
+        cur_ = blocks_[0].data;
+        end_ = cur_ + blocks_[0].size;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Formatters
+// ---------------------------------------------------------------------------
+
+size_t format_u64(char* buf, uint64_t value) {
+    char digits[20];
+    size_t i = sizeof(digits);
+    do {
+        digits[--i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    size_t len = sizeof(digits) - i;
+    std::memcpy(buf, digits + i, len);
+    return len;
+}
+
+size_t format_i64(char* buf, int64_t value) {
+    if (value >= 0) {
+        return format_u64(buf, static_cast<uint64_t>(value));
+    }
+    *buf = '-';
+    // Negate in unsigned space so INT64_MIN is handled.
+    return 1 + format_u64(buf + 1, ~static_cast<uint64_t>(value) + 1);
+}
+
+size_t format_double(char* buf, size_t cap, double value, int precision) {
+    int n = std::snprintf(buf, cap, "%.*f", precision, value);
+    return n < 0 ? 0 : (static_cast<size_t>(n) < cap ? static_cast<size_t>(n)
+                                                     : cap - 1);
+}
+
+size_t format_size(char* buf, size_t cap, uint64_t bytes) {
+    static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unit = 0;
+    double size = static_cast<double>(bytes);
+    while (size >= 1024.0 && unit < 4) {
+        size /= 1024.0;
+        unit++;
+    }
+
+    size_t len;
+    if (unit == 0) {
+        len = format_u64(buf, bytes);
+    } else {
+        len = format_double(buf, cap - 4, size, 1);
+    }
+    buf[len++] = ' ';
+    for (const char* u = units[unit]; *u; u++) {
+        buf[len++] = *u;
+    }
+    return len;
+}
+
+// ---------------------------------------------------------------------------
+// BufWriter
+// ---------------------------------------------------------------------------
+
+BufWriter::BufWriter(FILE* stream, size_t capacity)
+    : stream_(stream), buf_(capacity) {}
+
+BufWriter::~BufWriter() {
+    flush();
+}
+
+void BufWriter::need(size_t n) {
+    if (len_ + n > buf_.size()) {
+        flush();
+        if (n > buf_.size()) {
+            buf_.resize(n);
+        }
+    }
+}
+
+void BufWriter::write(std::string_view s) {
+    need(s.size());
+    std::memcpy(buf_.data() + len_, s.data(), s.size());
+    len_ += s.size();
+}
+
+void BufWriter::put(char c) {
+    need(1);
+    buf_[len_++] = c;
+}
+
+void BufWriter::put_u64(uint64_t value) {
+    need(20);
+    len_ += format_u64(buf_.data() + len_, value);
+}
+
+void BufWriter::put_i64(int64_t value) {
+    need(21);
+    len_ += format_i64(buf_.data() + len_, value);
+}
+
+void BufWriter::put_double(double value, int precision) {
+    need(352);  // worst-case %.17f on a huge double
+    len_ += format_double(buf_.data() + len_, 352, value, precision);
+}
+
+void BufWriter::put_size(uint64_t bytes) {
+    need(16);
+    len_ += format_size(buf_.data() + len_, 16, bytes);
+}
+
+void BufWriter::pad_left(std::string_view s, size_t width) {
+    size_t pad = s.size() < width ? width - s.size() : 0;
+    need(pad + s.size());
+    std::memset(buf_.data() + len_, ' ', pad);
+    len_ += pad;
+    std::memcpy(buf_.data() + len_, s.data(), s.size());
+    len_ += s.size();
+}
+
+void BufWriter::pad_right(std::string_view s, size_t width) {
+    size_t pad = s.size() < width ? width - s.size() : 0;
+    need(s.size() + pad);
+    std::memcpy(buf_.data() + len_, s.data(), s.size());
+    len_ += s.size();
+    std::memset(buf_.data() + len_, ' ', pad);
+    len_ += pad;
+}
+
+void BufWriter::flush() {
+    if (len_ > 0) {
+        std::fwrite(buf_.data(), 1, len_, stream_);
+        len_ = 0;
+    }
+    std::fflush(stream_);
+}
+
+// ---------------------------------------------------------------------------
+// Parsers
+// ---------------------------------------------------------------------------
+
+bool parse_i64(std::string_view s, int64_t& out) {
+    const char* first = s.data();
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc() && ptr == last && !s.empty();
+}
+
+bool parse_u64(std::string_view s, uint64_t& out) {
+    const char* first = s.data();
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc() && ptr == last && !s.empty();
+}
+
+bool parse_double(std::string_view s, double& out) {
+    const char* first = s.data();
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc() && ptr == last && !s.empty();
+}
+
+int64_t to_i64(std::string_view s, const char* what) {
+    int64_t value;
+    if (!parse_i64(s, value)) {
+        throw std::runtime_error(std::string("Invalid ") + what + ": " +
+                                 std::string(s));
+    }
+    return value;
+}
+
+double to_double(std::string_view s, const char* what) {
+    double value;
+    if (!parse_double(s, value)) {
+        throw std::runtime_error(std::string("Invalid ") + what + ": " +
+                                 std::string(s));
+    }
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// Tokenizers
+// ---------------------------------------------------------------------------
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t' ||
+                          s.front() == '\r' || s.front() == '\n')) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' ||
+                          s.back() == '\r' || s.back() == '\n')) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+} // namespace advbox
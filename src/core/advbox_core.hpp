@@ -0,0 +1,136 @@
+#ifndef ADVBOX_CORE_HPP
+#define ADVBOX_CORE_HPP
+
+// Shared fast-CLI runtime for the C++ tools in this suite: a bump
+// arena for short-lived allocations, a large buffered writer with
+// hand-rolled integer/double/size formatters (the iostream and
+// ostringstream paths these replace cost double-digit percentages of
+// runtime in the line-heavy tools), zero-copy string_view tokenizers,
+// and strict numeric parsers for argument handling.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace advbox {
+
+// Bump allocator over chained blocks. alloc() is a pointer increment
+// in the common case; reset() rewinds to the first block and keeps
+// the memory for reuse. Nothing is individually freed.
+class Arena {
+public:
+    explicit Arena(size_t block_size = 64 * 1024);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* alloc(size_t size, size_t align = alignof(max_align_t));
+
+    // NUL-terminated copy living in the arena; the view excludes the
+    // terminator.
+    std::string_view copy(std::string_view s);
+
+    void reset();
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    size_t block_size_;
+    size_t active_ = 0;  // block that cur_ points into
+    std::vector<Block> blocks_;
+};
+
+// Formatters appending into a caller buffer; each returns the number
+// of bytes written. format_u64 needs at most 20 bytes, format_i64 21,
+// format_size 16.
+size_t format_u64(char* buf, uint64_t value);
+size_t format_i64(char* buf, int64_t value);
+size_t format_double(char* buf, size_t cap, double value, int precision);
+// Human-readable size, "512 B" / "1.5 MB", units up to TB.
+size_t format_size(char* buf, size_t cap, uint64_t bytes);
+
+// Buffered writer over a FILE*. Output accumulates in one large
+// buffer and reaches the stream in bulk writes; the destructor
+// flushes. Not thread-safe — callers that share one writer across
+// threads must serialize on their own lock.
+class BufWriter {
+public:
+    explicit BufWriter(FILE* stream, size_t capacity = 1 << 20);
+    ~BufWriter();
+    BufWriter(const BufWriter&) = delete;
+    BufWriter& operator=(const BufWriter&) = delete;
+
+    void write(std::string_view s);
+    void put(char c);
+    void put_u64(uint64_t value);
+    void put_i64(int64_t value);
+    void put_double(double value, int precision);
+    void put_size(uint64_t bytes);
+
+    // Field padding for table output: pad_left right-justifies,
+    // pad_right left-justifies. Fields longer than width are written
+    // unclipped.
+    void pad_left(std::string_view s, size_t width);
+    void pad_right(std::string_view s, size_t width);
+
+    void flush();
+
+private:
+    void need(size_t n);
+
+    FILE* stream_;
+    std::vector<char> buf_;
+    size_t len_ = 0;
+};
+
+// Strict numeric parsers: the whole view must parse, no leading
+// whitespace. The to_* variants throw std::runtime_error with the
+// offending value for CLI argument handling.
+bool parse_i64(std::string_view s, int64_t& out);
+bool parse_u64(std::string_view s, uint64_t& out);
+bool parse_double(std::string_view s, double& out);
+int64_t to_i64(std::string_view s, const char* what);
+double to_double(std::string_view s, const char* what);
+
+// Zero-copy tokenizer with std::getline semantics: empty fields
+// between delimiters are yielded, a trailing delimiter does not
+// produce a final empty field.
+class Splitter {
+public:
+    Splitter(std::string_view s, char delim)
+        : rest_(s), delim_(delim), exhausted_(s.empty()) {}
+
+    bool next(std::string_view& out) {
+        if (exhausted_) {
+            return false;
+        }
+        size_t pos = rest_.find(delim_);
+        if (pos == std::string_view::npos) {
+            out = rest_;
+            exhausted_ = true;
+        } else {
+            out = rest_.substr(0, pos);
+            rest_.remove_prefix(pos + 1);
+            exhausted_ = rest_.empty();
+        }
+        return true;
+    }
+
+private:
+    std::string_view rest_;
+    char delim_;
+    bool exhausted_;
+};
+
+std::string_view trim(std::string_view s);
+
+} // namespace advbox
+
+#endif // ADVBOX_CORE_HPP
@@ -4,6 +4,9 @@
 #include <iomanip>
 #include <ctime>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 #include <stdexcept>
 
@@ -36,14 +39,62 @@ Date Formats:
     - yesterday
     - tomorrow
 
+Stream mode:
+    dateadd --stream <+/-> <number> <unit>
+                       Read one date per line from stdin and write the
+                       shifted date per line. Dates must be YYYY-MM-DD
+                       or YYYY-MM-DD HH:MM:SS; the output keeps the
+                       input's shape. Built for bulk offsets (billing
+                       periods over millions of records): pure integer
+                       calendar arithmetic, no libc time calls, no
+                       per-line allocations.
+
 Examples:
     dateadd now + 1 day
     dateadd today + 2 weeks
     dateadd 2024-01-01 + 3 months
     dateadd -f "%Y-%m-%d %H:%M:%S" now + 1 hour
     dateadd -u now + 30 minutes
+    dateadd --stream + 3 months < invoice_dates.txt
 )";
 
+// ---------------------------------------------------------------------------
+// Branch-light civil-calendar arithmetic (proleptic Gregorian). These
+// are constexpr so unit conversions fold at compile time, and they
+// touch no libc time state — unlike localtime/mktime they are
+// allocation-free, lock-free and thread-safe.
+// ---------------------------------------------------------------------------
+
+constexpr int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = unsigned(y - era * 400);
+    const unsigned doy = (153 * unsigned(m + (m > 2 ? -3 : 9)) + 2) / 5 + unsigned(d) - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + int64_t(doe) - 719468;
+}
+
+constexpr void civil_from_days(int64_t z, int& y, int& m, int& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = unsigned(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = int(doy - (153 * mp + 2) / 5 + 1);
+    m = int(mp + (mp < 10 ? 3 : -9));
+    y = int(yoe) + int(era) * 400 + (m <= 2);
+}
+
+constexpr bool is_leap(int y) {
+    return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+constexpr int days_in_month(int y, int m) {
+    constexpr int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && is_leap(y) ? 29 : lengths[m - 1];
+}
+
 class DateCalculator {
 private:
     std::string format = "%Y-%m-%d";
@@ -140,6 +191,16 @@ private:
         return mktime(timeinfo);
     }
 
+    // Parse exactly n ASCII digits; returns -1 on anything else.
+    static int parse_digits(const char* p, int n) {
+        int v = 0;
+        for (int i = 0; i < n; ++i) {
+            if (p[i] < '0' || p[i] > '9') return -1;
+            v = v * 10 + (p[i] - '0');
+        }
+        return v;
+    }
+
 public:
     void set_format(const std::string& fmt) {
         format = fmt;
@@ -165,11 +226,153 @@ public:
         
         time_t result = add_to_date(date, number, unit);
         struct tm* timeinfo = use_utc ? gmtime(&result) : localtime(&result);
-        
+
         char buffer[100];
         strftime(buffer, sizeof(buffer), format.c_str(), timeinfo);
         return std::string(buffer);
     }
+
+    // Stream mode: apply one fixed offset to dates read line-by-line
+    // from stdin. The offset is resolved to either a month delta or a
+    // second delta once up front; the per-line loop is then pure
+    // integer calendar arithmetic on fixed-width fields with buffered
+    // I/O and no allocations. Month overflow normalizes the same way
+    // mktime does (Jan 31 + 1 month rolls into March).
+    int run_stream(const std::string& op,
+                   const std::string& num_str,
+                   const std::string& unit) {
+        int64_t number = parse_number(num_str);
+        if (op == "-") {
+            number = -number;
+        }
+        else if (op != "+") {
+            throw std::runtime_error("Invalid operator: " + op);
+        }
+
+        int64_t month_delta = 0;
+        int64_t second_delta = 0;
+        if (unit == "y" || unit == "year" || unit == "years") {
+            month_delta = number * 12;
+        }
+        else if (unit == "m" || unit == "month" || unit == "months") {
+            month_delta = number;
+        }
+        else if (unit == "w" || unit == "week" || unit == "weeks") {
+            second_delta = number * 7 * 86400;
+        }
+        else if (unit == "d" || unit == "day" || unit == "days") {
+            second_delta = number * 86400;
+        }
+        else if (unit == "h" || unit == "hour" || unit == "hours") {
+            second_delta = number * 3600;
+        }
+        else if (unit == "min" || unit == "minute" || unit == "minutes") {
+            second_delta = number * 60;
+        }
+        else if (unit == "s" || unit == "second" || unit == "seconds") {
+            second_delta = number;
+        }
+        else {
+            throw std::runtime_error("Invalid unit: " + unit);
+        }
+
+        std::vector<char> rbuf(1 << 20);
+        std::vector<char> obuf(1 << 20);
+        size_t carry = 0, olen = 0;
+        size_t line = 1;
+        bool eof = false;
+
+        while (!eof || carry > 0) {
+            size_t got = 0;
+            if (!eof) {
+                got = fread(rbuf.data() + carry, 1, rbuf.size() - carry, stdin);
+                if (got < rbuf.size() - carry) eof = true;
+            }
+            size_t have = carry + got;
+
+            const char* p = rbuf.data();
+            const char* end = rbuf.data() + have;
+            while (p < end) {
+                const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+                if (!nl && !eof) break;  // partial line, refill
+                size_t len = (nl ? nl : end) - p;
+
+                if (len > 0) {
+                    int y = -1, mo = -1, d = -1, h = 0, mi = 0, s = 0;
+                    bool has_time = false;
+                    if (len >= 10 && p[4] == '-' && p[7] == '-') {
+                        y = parse_digits(p, 4);
+                        mo = parse_digits(p + 5, 2);
+                        d = parse_digits(p + 8, 2);
+                        if (len >= 19 && (p[10] == ' ' || p[10] == 'T') &&
+                            p[13] == ':' && p[16] == ':') {
+                            h = parse_digits(p + 11, 2);
+                            mi = parse_digits(p + 14, 2);
+                            s = parse_digits(p + 17, 2);
+                            has_time = true;
+                        }
+                    }
+                    if (y < 0 || mo < 1 || mo > 12 || d < 1 || h < 0 || mi < 0 || s < 0) {
+                        throw std::runtime_error("Invalid date on line "
+                                                 + std::to_string(line));
+                    }
+
+                    if (month_delta != 0) {
+                        int64_t months = int64_t(y) * 12 + (mo - 1) + month_delta;
+                        int64_t ny = months / 12;
+                        int nm = int(months % 12);
+                        if (nm < 0) { nm += 12; --ny; }
+                        y = int(ny);
+                        mo = nm + 1;
+                        while (d > days_in_month(y, mo)) {
+                            d -= days_in_month(y, mo);
+                            if (++mo > 12) { mo = 1; ++y; }
+                        }
+                    }
+                    else {
+                        int64_t t = days_from_civil(y, mo, d) * 86400 +
+                                    h * 3600 + mi * 60 + s + second_delta;
+                        int64_t days = t / 86400;
+                        int64_t sod = t % 86400;
+                        if (sod < 0) { sod += 86400; --days; }
+                        civil_from_days(days, y, mo, d);
+                        h = int(sod / 3600);
+                        mi = int((sod % 3600) / 60);
+                        s = int(sod % 60);
+                    }
+
+                    if (olen + 32 > obuf.size()) {
+                        fwrite(obuf.data(), 1, olen, stdout);
+                        olen = 0;
+                    }
+                    if (has_time) {
+                        olen += snprintf(obuf.data() + olen, 32,
+                                         "%04d-%02d-%02d %02d:%02d:%02d\n",
+                                         y, mo, d, h, mi, s);
+                    } else {
+                        olen += snprintf(obuf.data() + olen, 32,
+                                         "%04d-%02d-%02d\n", y, mo, d);
+                    }
+                }
+
+                if (!nl) { p = end; break; }
+                p = nl + 1;
+                ++line;
+            }
+
+            carry = end - p;
+            memmove(rbuf.data(), p, carry);
+            if (carry == rbuf.size()) {
+                throw std::runtime_error("Line too long on line " + std::to_string(line));
+            }
+            if (eof && got == 0) carry = 0;
+        }
+
+        if (olen > 0) {
+            fwrite(obuf.data(), 1, olen, stdout);
+        }
+        return 0;
+    }
 };
 
 int main(int argc, char* argv[]) {
@@ -183,7 +386,24 @@ int main(int argc, char* argv[]) {
         
         DateCalculator calc;
         size_t arg_index = 0;
-        
+
+        if (args[0] == "--stream") {
+            // Accept either separate arguments or one quoted string
+            // ('--stream + 3 months' / "--stream '+ 3 months'").
+            std::vector<std::string> spec;
+            for (size_t i = 1; i < args.size(); ++i) {
+                std::istringstream ss(args[i]);
+                std::string word;
+                while (ss >> word) {
+                    spec.push_back(word);
+                }
+            }
+            if (spec.size() != 3) {
+                throw std::runtime_error("--stream requires <+/-> <number> <unit>");
+            }
+            return calc.run_stream(spec[0], spec[1], spec[2]);
+        }
+
         // Parse options
         while (arg_index < args.size() && args[arg_index][0] == '-') {
             if (args[arg_index] == "-f" || args[arg_index] == "--format") {
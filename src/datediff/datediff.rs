@@ -1,4 +1,5 @@
 use std::env;
+use std::io::{self, Read, Write};
 use std::process;
 use std::time::{SystemTime, UNIX_EPOCH};
 
@@ -14,6 +15,9 @@ Options:
     -u, --unit <unit>  Output unit (years|months|days|hours|minutes|seconds)
     -f, --format       Format output as detailed breakdown
     -s, --simple       Simple output (only numbers)
+    --stream           Read two timestamps per line from stdin and
+                       print one difference per line (integer, in the
+                       unit given with -u, seconds by default)
 
 Date Formats:
     YYYY-MM-DD
@@ -29,6 +33,7 @@ Examples:
     datediff -n "2024-01-01"
     datediff -u days "2024-01-01" "2024-02-01"
     datediff -f "2024-01-01 12:00:00" "2024-01-02 15:30:45"
+    datediff --stream -u days < dumped_rows.txt
 "#;
 
 #[derive(Debug, Clone, Copy)]
@@ -147,76 +152,52 @@ impl DateTime {
     }
 }
 
+// Days between 1970-01-01 and the given civil date, in closed form
+// (no per-year or per-month loops; the era trick handles leap rules
+// for the whole proleptic Gregorian calendar).
+fn days_from_civil(year: i32, month: u32, day: u32) -> i64 {
+    let y = year as i64 - (month <= 2) as i64;
+    let m = month as i64;
+    let d = day as i64;
+    let era = if y >= 0 { y } else { y - 399 } / 400;
+    let yoe = y - era * 400;
+    let doy = (153 * (m + if m > 2 { -3 } else { 9 }) + 2) / 5 + d - 1;
+    let doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    era * 146097 + doe - 719468
+}
+
+// Inverse of days_from_civil, also loop-free.
+fn civil_from_days(days: i64) -> (i32, u32, u32) {
+    let z = days + 719468;
+    let era = if z >= 0 { z } else { z - 146096 } / 146097;
+    let doe = z - era * 146097;
+    let yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    let y = yoe + era * 400;
+    let doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    let mp = (5 * doy + 2) / 153;
+    let d = doy - (153 * mp + 2) / 5 + 1;
+    let m = mp + if mp < 10 { 3 } else { -9 };
+    ((y + (m <= 2) as i64) as i32, m as u32, d as u32)
+}
+
 // Convert a date to seconds since the Unix epoch
-fn date_to_seconds(year: i32, month: u32, day: u32, 
+fn date_to_seconds(year: i32, month: u32, day: u32,
                   hour: u32, minute: u32, second: u32) -> i64 {
-    let days_before_month = [0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334];
-    
-    let mut years = year - 1970;
-    let mut days = days_before_month[month as usize - 1] + day - 1;
-    
-    // Add extra days for leap years
-    let leap_years = (1968 + years) / 4 - (1968 + years) / 100 + (1968 + years) / 400 
-                    - (1968) / 4 + (1968) / 100 - (1968) / 400;
-    days += leap_years as u32;
-    
-    // Check if the current year is a leap year
-    if month > 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0) {
-        days += 1;
-    }
-    
-    days as i64 * 86400 + hour as i64 * 3600 + minute as i64 * 60 + second as i64
+    days_from_civil(year, month, day) * 86400
+        + hour as i64 * 3600 + minute as i64 * 60 + second as i64
 }
 
 // Convert seconds since the Unix epoch to a date
 fn seconds_to_date(secs: i64) -> (i32, u32, u32, u32, u32, u32) {
-    let days = secs / 86400;
-    let secs_of_day = secs % 86400;
-    
+    let days = secs.div_euclid(86400);
+    let secs_of_day = secs.rem_euclid(86400);
+
     let hour = (secs_of_day / 3600) as u32;
     let minute = ((secs_of_day % 3600) / 60) as u32;
     let second = (secs_of_day % 60) as u32;
-    
-    let mut year = 1970;
-    let mut days_remaining = days;
-    
-    while days_remaining >= 365 {
-        let days_in_year = if (year % 4 == 0 && year % 100 != 0) || year % 400 == 0 {
-            366
-        } else {
-            365
-        };
-        
-        if days_remaining >= days_in_year {
-            days_remaining -= days_in_year;
-            year += 1;
-        } else {
-            break;
-        }
-    }
-    
-    let month_days = [31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31];
-    let mut month = 1;
-    let mut day = days_remaining + 1;
-    
-    // Adjust for leap year
-    let is_leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
-    
-    for (i, &days_in_month) in month_days.iter().enumerate() {
-        let mut dim = days_in_month;
-        if i == 1 && is_leap {
-            dim += 1;
-        }
-        
-        if day > dim {
-            day -= dim;
-            month += 1;
-        } else {
-            break;
-        }
-    }
-    
-    (year, month as u32, day as u32, hour, minute, second)
+
+    let (year, month, day) = civil_from_days(days);
+    (year, month, day, hour, minute, second)
 }
 
 #[derive(Debug)]
@@ -315,6 +296,212 @@ fn format_diff(diff: &TimeDiff, unit: Option<&str>, format: bool, simple: bool)
     }
 }
 
+// ---------------------------------------------------------------------------
+// Stream mode
+//
+// Two timestamps per stdin line, one integer difference per output
+// line. The parser is fixed-width over the raw bytes ("YYYY-MM-DD"
+// optionally followed by " HH:MM:SS" or "THH:MM:SS"), epoch seconds
+// come from the closed-form conversion above, and output is formatted
+// by hand into one buffer flushed in megabyte batches — no allocation
+// on the per-line path.
+// ---------------------------------------------------------------------------
+
+const STREAM_BUF: usize = 1 << 16;
+const OUT_FLUSH: usize = 1 << 20;
+
+fn unit_divisor(unit: Option<&str>) -> Option<i64> {
+    match unit {
+        None | Some("seconds") => Some(1),
+        Some("minutes") => Some(60),
+        Some("hours") => Some(3600),
+        Some("days") => Some(86400),
+        Some("months") => Some(30 * 86400),
+        Some("years") => Some(365 * 86400),
+        _ => None,
+    }
+}
+
+// Fixed-width decimal field; the caller has checked the length.
+fn parse_digits(s: &[u8]) -> Option<i64> {
+    let mut v: i64 = 0;
+    for &c in s {
+        if !c.is_ascii_digit() {
+            return None;
+        }
+        v = v * 10 + (c - b'0') as i64;
+    }
+    Some(v)
+}
+
+// Parse one timestamp at the start of `s`; returns epoch seconds and
+// the number of bytes consumed. A date followed by another date on the
+// same line is disambiguated by the ':' at offset 13.
+fn parse_timestamp(s: &[u8]) -> Option<(i64, usize)> {
+    if s.len() < 10 || s[4] != b'-' || s[7] != b'-' {
+        return None;
+    }
+    let year = parse_digits(&s[0..4])?;
+    let month = parse_digits(&s[5..7])?;
+    let day = parse_digits(&s[8..10])?;
+    if month < 1 || month > 12 || day < 1 || day > 31 {
+        return None;
+    }
+
+    let has_time = s.len() >= 19
+        && (s[10] == b' ' || s[10] == b'T')
+        && s[13] == b':' && s[16] == b':';
+    let (hour, minute, second, used) = if has_time {
+        let h = parse_digits(&s[11..13])?;
+        let m = parse_digits(&s[14..16])?;
+        let sec = parse_digits(&s[17..19])?;
+        if h > 23 || m > 59 || sec > 59 {
+            return None;
+        }
+        (h, m, sec, 19)
+    } else {
+        (0, 0, 0, 10)
+    };
+
+    let secs = days_from_civil(year as i32, month as u32, day as u32) * 86400
+        + hour * 3600 + minute * 60 + second;
+    Some((secs, used))
+}
+
+fn push_i64(out: &mut Vec<u8>, v: i64) {
+    if v < 0 {
+        out.push(b'-');
+        // Avoid overflow on i64::MIN by formatting the leading digit
+        // separately.
+        let high = v / 10;
+        if high != 0 {
+            push_i64_pos(out, -high);
+        }
+        out.push(b'0' + (-(v % 10)) as u8);
+        return;
+    }
+    push_i64_pos(out, v);
+}
+
+fn push_i64_pos(out: &mut Vec<u8>, v: i64) {
+    let mut digits = [0u8; 20];
+    let mut i = digits.len();
+    let mut v = v;
+    loop {
+        i -= 1;
+        digits[i] = b'0' + (v % 10) as u8;
+        v /= 10;
+        if v == 0 {
+            break;
+        }
+    }
+    out.extend_from_slice(&digits[i..]);
+}
+
+fn process_stream_line(line: &[u8], divisor: i64, out: &mut Vec<u8>) -> bool {
+    let (sec1, used) = match parse_timestamp(line) {
+        Some(r) => r,
+        None => return false,
+    };
+    let mut rest = &line[used..];
+    if rest.first() != Some(&b' ') && rest.first() != Some(&b'\t') {
+        return false;
+    }
+    while rest.first() == Some(&b' ') || rest.first() == Some(&b'\t') {
+        rest = &rest[1..];
+    }
+    let (sec2, used2) = match parse_timestamp(rest) {
+        Some(r) => r,
+        None => return false,
+    };
+    if used2 != rest.len() {
+        return false;
+    }
+    push_i64(out, (sec2 - sec1) / divisor);
+    out.push(b'\n');
+    true
+}
+
+fn run_stream(unit: Option<&str>) -> i32 {
+    let divisor = match unit_divisor(unit) {
+        Some(d) => d,
+        None => {
+            eprintln!("Error: Invalid unit: {}", unit.unwrap_or(""));
+            return 1;
+        }
+    };
+
+    let mut stdin = io::stdin();
+    let stdout = io::stdout();
+    let mut stdout = stdout.lock();
+    let mut buf = vec![0u8; STREAM_BUF];
+    let mut carry: Vec<u8> = Vec::new();
+    let mut out: Vec<u8> = Vec::with_capacity(OUT_FLUSH + 64);
+    let mut line_no: u64 = 0;
+
+    loop {
+        let n = match stdin.read(&mut buf) {
+            Ok(n) => n,
+            Err(e) => {
+                eprintln!("Error reading stdin: {}", e);
+                return 1;
+            }
+        };
+        let eof = n == 0;
+        let chunk = &buf[..n];
+        let mut start = 0;
+        while let Some(pos) = chunk[start..].iter().position(|&c| c == b'\n') {
+            let mut line: &[u8] = &chunk[start..start + pos];
+            start += pos + 1;
+            line_no += 1;
+            if !carry.is_empty() {
+                carry.extend_from_slice(line);
+                line = &carry;
+            }
+            let line = match line.last() {
+                Some(b'\r') => &line[..line.len() - 1],
+                _ => line,
+            };
+            if !line.is_empty() && !process_stream_line(line, divisor, &mut out) {
+                // Keep the results for the lines before the bad one
+                let _ = stdout.write_all(&out).and_then(|_| stdout.flush());
+                eprintln!("Error: Invalid timestamps on line {}", line_no);
+                return 1;
+            }
+            carry.clear();
+        }
+        carry.extend_from_slice(&chunk[start..]);
+
+        if eof {
+            if !carry.is_empty() {
+                line_no += 1;
+                let line: Vec<u8> = std::mem::take(&mut carry);
+                let line = match line.last() {
+                    Some(b'\r') => &line[..line.len() - 1],
+                    _ => &line[..],
+                };
+                if !line.is_empty() && !process_stream_line(line, divisor, &mut out) {
+                    let _ = stdout.write_all(&out).and_then(|_| stdout.flush());
+                    eprintln!("Error: Invalid timestamps on line {}", line_no);
+                    return 1;
+                }
+            }
+            break;
+        }
+        if out.len() >= OUT_FLUSH {
+            if stdout.write_all(&out).is_err() {
+                return 0; // consumer went away
+            }
+            out.clear();
+        }
+    }
+
+    if stdout.write_all(&out).is_err() || stdout.flush().is_err() {
+        return 0;
+    }
+    0
+}
+
 fn main() {
     let args: Vec<String> = env::args().collect();
     let mut date1_str = String::new();
@@ -323,6 +510,7 @@ fn main() {
     let mut unit = None;
     let mut format = false;
     let mut simple = false;
+    let mut stream = false;
     
     let mut i = 1;
     while i < args.len() {
@@ -352,6 +540,10 @@ fn main() {
                 simple = true;
                 i += 1;
             }
+            "--stream" => {
+                stream = true;
+                i += 1;
+            }
             _ => {
                 if date1_str.is_empty() {
                     date1_str = args[i].clone();
@@ -363,6 +555,10 @@ fn main() {
         }
     }
 
+    if stream {
+        process::exit(run_stream(unit));
+    }
+
     if date1_str.is_empty() {
         eprintln!("Error: First date not specified");
         eprintln!("Try 'datediff --help' for more information.");
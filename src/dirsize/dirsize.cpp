@@ -1,16 +1,28 @@
 #include <iostream>
 #include <string>
+#include <cstring>
 #include <vector>
 #include <filesystem>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
 #include <map>
+#include <unordered_map>
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <queue>
-#include <condition_variable>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "advbox_core.hpp"
 
 namespace fs = std::filesystem;
 
@@ -29,6 +41,11 @@ Options:
     -u, --human       Show sizes in human readable format
     --no-sort         Don't sort output by size
     --threads N       Number of threads for calculation (default: 4)
+    --fast            Use the raw getdents64/statx traversal engine (Linux only)
+    --cache FILE      Persist sizes to FILE and skip subtrees whose mtime is unchanged
+    --top N           Report only the N largest files, in constant memory
+    --dedupe-links    Count multi-linked files once (rsnapshot-style trees)
+    --profile         Report per-thread stage timings on stderr after the run
 
 Examples:
     dirsize              # Current directory
@@ -38,6 +55,222 @@ Examples:
     dirsize --threads 8  # Use 8 threads for calculation
 )";
 
+// On-disk cache layout: a fixed header, records sorted by path_hash, then
+// a blob of NUL-terminated child-directory names, so a reader can mmap the
+// file and binary-search it directly with no parsing or allocation. A
+// record is fresh when the directory's mtime and inode still match; a hit
+// skips enumerating the directory (its size and child list come from the
+// record) but the walk still descends into the cached children, because a
+// POSIX directory mtime does not propagate upward — every directory is
+// re-validated, only unchanged ones skip their getdents/statx work. The
+// remaining blind spot is a file rewritten in place, which bumps no
+// directory mtime at all.
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    uint64_t names_len;
+};
+
+struct CacheRecord {
+    uint64_t path_hash;
+    uint64_t mtime_sec;
+    uint32_t mtime_nsec;
+    uint32_t child_count;
+    uint64_t ino;
+    uint64_t self_size;
+    uint64_t child_names_off;
+};
+
+static_assert(sizeof(CacheHeader) == 24, "cache header layout is part of the format");
+static_assert(sizeof(CacheRecord) == 48, "cache record layout is part of the format");
+
+// Concurrent set of (device, inode) pairs for hardlink dedup. Keys are
+// spread over 256 independently locked open-addressing tables, so worker
+// threads only contend when they hash into the same shard — unlike one
+// mutex-guarded std::set, which would serialize every file. Each shard
+// grows by rehashing at 70% load; a zeroed slot means empty (no real file
+// has inode 0).
+class InodeSet {
+public:
+    // Returns true if (dev, ino) was not seen before.
+    bool insert(uint64_t dev, uint64_t ino) {
+        uint64_t h = mix(dev, ino);
+        Shard& shard = shards_[h & (kShards - 1)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        if ((shard.used + 1) * 10 >= shard.slots.size() * 7) {
+            grow(shard);
+        }
+
+        size_t mask = shard.slots.size() - 1;
+        for (size_t i = (h >> 8) & mask;; i = (i + 1) & mask) {
+            Slot& slot = shard.slots[i];
+            if (slot.dev == 0 && slot.ino == 0) {
+                slot.dev = dev;
+                slot.ino = ino;
+                shard.used++;
+                return true;
+            }
+            if (slot.dev == dev && slot.ino == ino) {
+                return false;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kShards = 256;
+
+    struct Slot {
+        uint64_t dev;
+        uint64_t ino;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Slot> slots = std::vector<Slot>(1024);
+        size_t used = 0;
+    };
+
+    static uint64_t mix(uint64_t dev, uint64_t ino) {
+        return ino * 0x9E3779B97F4A7C15ull ^ dev * 0xC2B2AE3D27D4EB4Full;
+    }
+
+    static void grow(Shard& shard) {
+        std::vector<Slot> old;
+        old.swap(shard.slots);
+        shard.slots.assign(old.size() * 2, Slot{0, 0});
+        size_t mask = shard.slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.dev == 0 && slot.ino == 0) {
+                continue;
+            }
+            for (size_t i = (mix(slot.dev, slot.ino) >> 8) & mask;;
+                 i = (i + 1) & mask) {
+                if (shard.slots[i].dev == 0 && shard.slots[i].ino == 0) {
+                    shard.slots[i] = slot;
+                    break;
+                }
+            }
+        }
+    }
+
+    Shard shards_[kShards];
+};
+
+// A unit of traversal work: one directory together with its depth, so
+// depth limits survive the trip through the scheduler.
+struct WorkItem {
+    fs::path path;
+    int depth;
+};
+
+// Chase-Lev work-stealing deque. The owning worker pushes and pops at the
+// bottom without contention; other workers steal single items from the top
+// with a CAS. The ring grows on demand; retired rings are kept alive until
+// destruction because a slow thief may still be reading them.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 1024)
+        : array_(new Array(capacity)) {}
+
+    ~WorkStealingDeque() {
+        delete array_.load(std::memory_order_relaxed);
+        for (Array* a : retired_) {
+            delete a;
+        }
+    }
+
+    // Owner only.
+    void push(WorkItem* item) {
+        long b = bottom_.load(std::memory_order_relaxed);
+        long t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t >= static_cast<long>(a->capacity)) {
+            a = grow(a, b, t);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only.
+    WorkItem* pop() {
+        long b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            // Deque was empty; restore bottom
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        WorkItem* item = a->get(b);
+        if (t == b) {
+            // Last item: race against thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread.
+    WorkItem* steal() {
+        long t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Array* a = array_.load(std::memory_order_acquire);
+        WorkItem* item = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+private:
+    struct Array {
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<WorkItem*>[]> slots;
+
+        explicit Array(size_t c)
+            : capacity(c), mask(c - 1),
+              slots(new std::atomic<WorkItem*>[c]) {}
+
+        void put(long i, WorkItem* p) {
+            slots[i & mask].store(p, std::memory_order_relaxed);
+        }
+        WorkItem* get(long i) {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+    };
+
+    Array* grow(Array* old, long b, long t) {
+        Array* bigger = new Array(old->capacity * 2);
+        for (long i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        retired_.push_back(old);
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<long> top_{0};
+    std::atomic<long> bottom_{0};
+    std::atomic<Array*> array_;
+    std::vector<Array*> retired_;
+};
+
 class DirSize {
 private:
     bool show_all;
@@ -47,36 +280,126 @@ private:
     bool human_readable;
     bool sort_output;
     int thread_count;
+    bool fast_mode;
     std::mutex print_mutex;
-    std::mutex queue_mutex;
-    std::condition_variable cv;
-    bool processing_complete = false;
-    std::queue<fs::path> work_queue;
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+    std::atomic<size_t> pending_work{0};
     std::map<fs::path, uintmax_t> dir_sizes;
 
-    static std::string format_size(uintmax_t size, bool human) {
-        if (!human) {
-            return std::to_string(size);
-        }
+    struct PendingDir {
+        CacheRecord rec;
+        std::vector<std::string> children;
+    };
+
+    std::string cache_file;
+    void* cache_map = nullptr;
+    size_t cache_map_len = 0;
+    const CacheRecord* cache_records = nullptr;
+    size_t cache_record_count = 0;
+    const char* cache_names = nullptr;
+    size_t cache_names_len = 0;
+    std::mutex cache_mutex;
+    std::map<fs::path, PendingDir> cache_pending;
+
+    // --top mode: a min-heap of the N largest files seen so far. Nothing
+    // else is retained, so memory stays O(N) regardless of tree size.
+    // top_floor caches the smallest size in a full heap, so workers can
+    // reject most files with one relaxed load instead of taking the lock.
+    size_t top_n = 0;
+    std::mutex top_mutex;
+    std::priority_queue<std::pair<uintmax_t, fs::path>,
+                        std::vector<std::pair<uintmax_t, fs::path>>,
+                        std::greater<>> top_heap;
+    std::atomic<bool> top_full{false};
+    std::atomic<uintmax_t> top_floor{0};
+
+    bool dedupe_links = false;
+    InodeSet linked_inodes;
+
+    // All result printing funnels through one buffered writer; workers
+    // append under print_mutex, the final report runs single-threaded.
+    advbox::BufWriter list_out{stdout};
 
-        const char* units[] = {"B", "KB", "MB", "GB", "TB"};
-        int unit = 0;
-        double size_d = static_cast<double>(size);
+    // --profile: each worker accumulates stage times in its own slot
+    // (no sharing, no atomics on the hot path) and everything is merged
+    // once after join. When profiling is off the per-entry cost is one
+    // predictable branch.
+    struct WorkerProfile {
+        uint64_t enumerate_ns = 0;  // getdents / directory iteration
+        uint64_t stat_ns = 0;       // statx / file_size
+        uint64_t idle_ns = 0;       // waiting for stealable work
+        uint64_t entries = 0;
+        uint64_t dirs = 0;
+    };
 
-        while (size_d >= 1024.0 && unit < 4) {
-            size_d /= 1024.0;
-            unit++;
+    bool profiling = false;
+    std::vector<WorkerProfile> profiles;
+    std::atomic<uint64_t> queue_hwm{0};
+
+    static uint64_t prof_now() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+               static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    void note_queue_depth(uint64_t depth) {
+        uint64_t seen = queue_hwm.load(std::memory_order_relaxed);
+        while (depth > seen &&
+               !queue_hwm.compare_exchange_weak(seen, depth,
+                                                std::memory_order_relaxed)) {
         }
+    }
 
-        std::ostringstream ss;
-        ss << std::fixed << std::setprecision(1);
-        if (unit == 0) {
-            ss << static_cast<uintmax_t>(size_d);
-        } else {
-            ss << size_d;
+    void print_profile(uint64_t wall_ns) const {
+        double wall_s = static_cast<double>(wall_ns) / 1e9;
+        fprintf(stderr, "\nProfile: %.1f ms wall, queue high-water %llu\n",
+                wall_s * 1000.0,
+                static_cast<unsigned long long>(
+                    queue_hwm.load(std::memory_order_relaxed)));
+        fprintf(stderr, "%6s %12s %12s %12s %10s %8s %12s\n",
+                "thread", "enumerate", "stat", "idle",
+                "entries", "dirs", "entries/s");
+
+        WorkerProfile sum;
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            const WorkerProfile& p = profiles[i];
+            fprintf(stderr, "%6zu %9.1f ms %9.1f ms %9.1f ms %10llu %8llu %12.0f\n",
+                    i,
+                    static_cast<double>(p.enumerate_ns) / 1e6,
+                    static_cast<double>(p.stat_ns) / 1e6,
+                    static_cast<double>(p.idle_ns) / 1e6,
+                    static_cast<unsigned long long>(p.entries),
+                    static_cast<unsigned long long>(p.dirs),
+                    wall_s > 0.0 ? static_cast<double>(p.entries) / wall_s : 0.0);
+            sum.enumerate_ns += p.enumerate_ns;
+            sum.stat_ns += p.stat_ns;
+            sum.idle_ns += p.idle_ns;
+            sum.entries += p.entries;
+            sum.dirs += p.dirs;
         }
-        ss << " " << units[unit];
-        return ss.str();
+        fprintf(stderr, "%6s %9.1f ms %9.1f ms %9.1f ms %10llu %8llu %12.0f\n",
+                "total",
+                static_cast<double>(sum.enumerate_ns) / 1e6,
+                static_cast<double>(sum.stat_ns) / 1e6,
+                static_cast<double>(sum.idle_ns) / 1e6,
+                static_cast<unsigned long long>(sum.entries),
+                static_cast<unsigned long long>(sum.dirs),
+                wall_s > 0.0 ? static_cast<double>(sum.entries) / wall_s : 0.0);
+    }
+
+    // Index of the deque owned by the current thread; the main thread
+    // seeds deque 0 before any worker starts.
+    static thread_local int worker_index;
+
+    // One right-justified size field into the writer; human sizes go
+    // through the shared formatter instead of an ostringstream.
+    static void put_size_field(advbox::BufWriter& out, uintmax_t size,
+                               bool human) {
+        char buf[24];
+        size_t len = human ? advbox::format_size(buf, sizeof(buf), size)
+                           : advbox::format_u64(buf, size);
+        out.pad_left(std::string_view(buf, len), 15);
     }
 
     bool should_process_file(const fs::path& path) {
@@ -86,35 +409,355 @@ private:
         return true;
     }
 
+    static uint64_t make_dev(const struct statx& stx) {
+        return (static_cast<uint64_t>(stx.stx_dev_major) << 32) |
+               stx.stx_dev_minor;
+    }
+
+    static uint64_t hash_path(const fs::path& path) {
+        // FNV-1a, 64-bit
+        uint64_t h = 14695981039346656037ull;
+        for (char c : path.native()) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    void load_cache() {
+        int fd = open(cache_file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            // First run with this cache file
+            return;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 ||
+            static_cast<size_t>(st.st_size) < sizeof(CacheHeader)) {
+            close(fd);
+            return;
+        }
+
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return;
+        }
+
+        const auto* hdr = static_cast<const CacheHeader*>(map);
+        uint64_t expected = sizeof(CacheHeader) +
+                            hdr->count * sizeof(CacheRecord) + hdr->names_len;
+        if (std::memcmp(hdr->magic, "DSZC", 4) != 0 || hdr->version != 2 ||
+            expected != static_cast<uint64_t>(st.st_size) ||
+            (hdr->names_len > 0 &&
+             static_cast<const char*>(map)[st.st_size - 1] != '\0')) {
+            munmap(map, st.st_size);
+            return;
+        }
+
+        cache_map = map;
+        cache_map_len = st.st_size;
+        cache_records = reinterpret_cast<const CacheRecord*>(hdr + 1);
+        cache_record_count = hdr->count;
+        cache_names = reinterpret_cast<const char*>(cache_records + hdr->count);
+        cache_names_len = hdr->names_len;
+    }
+
+    const CacheRecord* cache_lookup(uint64_t hash) const {
+        const CacheRecord* end = cache_records + cache_record_count;
+        const CacheRecord* it = std::lower_bound(cache_records, end, hash,
+            [](const CacheRecord& rec, uint64_t h) {
+                return rec.path_hash < h;
+            });
+        return (it != end && it->path_hash == hash) ? it : nullptr;
+    }
+
+    // Stats the directory, fills in its current cache identity, and
+    // returns the matching record when it is still fresh (same mtime and
+    // inode), or nullptr when the directory must be enumerated.
+    const CacheRecord* cache_probe(const fs::path& dir, CacheRecord& rec,
+                                   bool& have_identity) {
+        struct statx stx;
+        if (statx(AT_FDCWD, dir.c_str(), AT_SYMLINK_NOFOLLOW,
+                  STATX_MTIME | STATX_INO, &stx) != 0) {
+            return nullptr;
+        }
+        have_identity = true;
+
+        rec = CacheRecord{};
+        rec.path_hash = hash_path(dir);
+        rec.mtime_sec = stx.stx_mtime.tv_sec;
+        rec.mtime_nsec = stx.stx_mtime.tv_nsec;
+        rec.ino = stx.stx_ino;
+
+        const CacheRecord* hit = cache_lookup(rec.path_hash);
+        if (hit &&
+            hit->mtime_sec == rec.mtime_sec &&
+            hit->mtime_nsec == rec.mtime_nsec &&
+            hit->ino == rec.ino &&
+            hit->child_names_off <= cache_names_len) {
+            return hit;
+        }
+        return nullptr;
+    }
+
+    void cache_note(const fs::path& dir, PendingDir&& pending) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        cache_pending[dir] = std::move(pending);
+    }
+
+    // Serves a directory entirely from a fresh cache record: its own size
+    // and its child-directory list come from the cache, no getdents or
+    // per-file statx. The children are still enqueued so they get
+    // validated (or rescanned) themselves.
+    void process_directory_cached(const fs::path& dir, int current_depth,
+                                  const CacheRecord& rec, const CacheRecord* hit) {
+        {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            dir_sizes[dir] = hit->self_size;
+        }
+
+        PendingDir pending;
+        pending.rec = rec;
+        const char* p = cache_names + hit->child_names_off;
+        const char* end = cache_names + cache_names_len;
+        for (uint32_t i = 0; i < hit->child_count && p < end; ++i) {
+            std::string name(p);
+            p += name.size() + 1;
+            enqueue_directory(dir / name, current_depth + 1);
+            pending.children.push_back(std::move(name));
+        }
+        cache_note(dir, std::move(pending));
+    }
+
+    void save_cache() {
+        std::vector<CacheRecord> records;
+        std::string names;
+        records.reserve(cache_pending.size());
+
+        for (auto& [path, pending] : cache_pending) {
+            auto it = dir_sizes.find(path);
+            if (it == dir_sizes.end()) {
+                continue;
+            }
+            CacheRecord out = pending.rec;
+            out.self_size = it->second;
+            out.child_count = static_cast<uint32_t>(pending.children.size());
+            out.child_names_off = names.size();
+            for (const auto& name : pending.children) {
+                names.append(name);
+                names.push_back('\0');
+            }
+            records.push_back(out);
+        }
+
+        // Carry forward records this run never reached (e.g. cut off by
+        // -d); their names are copied from the old blob so they stay
+        // usable next time.
+        if (cache_record_count > 0) {
+            std::vector<uint64_t> seen;
+            seen.reserve(records.size());
+            for (const auto& rec : records) {
+                seen.push_back(rec.path_hash);
+            }
+            std::sort(seen.begin(), seen.end());
+            for (size_t i = 0; i < cache_record_count; ++i) {
+                CacheRecord old = cache_records[i];
+                if (std::binary_search(seen.begin(), seen.end(), old.path_hash) ||
+                    old.child_names_off > cache_names_len) {
+                    continue;
+                }
+                const char* p = cache_names + old.child_names_off;
+                const char* end = cache_names + cache_names_len;
+                uint64_t off = names.size();
+                uint32_t copied = 0;
+                for (; copied < old.child_count && p < end; ++copied) {
+                    size_t len = std::strlen(p);
+                    names.append(p, len + 1);
+                    p += len + 1;
+                }
+                old.child_names_off = off;
+                old.child_count = copied;
+                records.push_back(old);
+            }
+        }
+
+        std::sort(records.begin(), records.end(),
+            [](const CacheRecord& a, const CacheRecord& b) {
+                return a.path_hash < b.path_hash;
+            });
+
+        std::string tmp = cache_file + ".tmp";
+        int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Warning: cannot write cache: " << cache_file << std::endl;
+            return;
+        }
+
+        CacheHeader hdr{};
+        std::memcpy(hdr.magic, "DSZC", 4);
+        hdr.version = 2;
+        hdr.count = records.size();
+        hdr.names_len = names.size();
+
+        bool ok = write(fd, &hdr, sizeof(hdr)) == static_cast<ssize_t>(sizeof(hdr));
+        if (ok && !records.empty()) {
+            size_t bytes = records.size() * sizeof(CacheRecord);
+            ok = write(fd, records.data(), bytes) == static_cast<ssize_t>(bytes);
+        }
+        if (ok && !names.empty()) {
+            ok = write(fd, names.data(), names.size()) ==
+                 static_cast<ssize_t>(names.size());
+        }
+        close(fd);
+
+        if (!ok || rename(tmp.c_str(), cache_file.c_str()) != 0) {
+            std::cerr << "Warning: cannot write cache: " << cache_file << std::endl;
+            unlink(tmp.c_str());
+        }
+    }
+
+    void offer_top(const fs::path& path, uintmax_t size) {
+        if (top_full.load(std::memory_order_relaxed) &&
+            size <= top_floor.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(top_mutex);
+        if (top_heap.size() < top_n) {
+            top_heap.emplace(size, path);
+        } else if (size > top_heap.top().first) {
+            top_heap.pop();
+            top_heap.emplace(size, path);
+        }
+        if (top_heap.size() >= top_n) {
+            top_floor.store(top_heap.top().first, std::memory_order_relaxed);
+            top_full.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void enqueue_directory(const fs::path& dir, int depth) {
+        uint64_t prev = pending_work.fetch_add(1, std::memory_order_relaxed);
+        if (profiling) {
+            note_queue_depth(prev + 1);
+        }
+        deques[worker_index]->push(new WorkItem{dir, depth});
+    }
+
+    void record_directory(const fs::path& dir, uintmax_t total_size,
+                          std::vector<std::pair<fs::path, uintmax_t>>& entries) {
+        std::lock_guard<std::mutex> lock(print_mutex);
+        dir_sizes[dir] = total_size;
+
+        if (!summarize) {
+            if (sort_output) {
+                std::sort(entries.begin(), entries.end(),
+                    [](const auto& a, const auto& b) {
+                        return a.second > b.second;
+                    });
+            }
+
+            for (const auto& entry : entries) {
+                if (entry.second >= threshold) {
+                    put_size_field(list_out, entry.second, human_readable);
+                    list_out.write("  ");
+                    list_out.write(entry.first.filename().string());
+                    list_out.put('\n');
+                }
+            }
+        }
+    }
+
     void process_directory(const fs::path& dir, int current_depth) {
         if (max_depth != -1 && current_depth > max_depth) {
             return;
         }
 
+        PendingDir pending;
+        bool have_identity = false;
+        // --top and --dedupe-links have to see every file, so cached
+        // subtrees cannot be pruned
+        if (!cache_file.empty() && top_n == 0 && !dedupe_links) {
+            const CacheRecord* hit = cache_probe(dir, pending.rec, have_identity);
+            if (hit) {
+                process_directory_cached(dir, current_depth, pending.rec, hit);
+                return;
+            }
+        }
+        PendingDir* collect = have_identity ? &pending : nullptr;
+
+        if (fast_mode) {
+            process_directory_fast(dir, current_depth, collect);
+        } else {
+            process_directory_slow(dir, current_depth, collect);
+        }
+
+        if (collect) {
+            cache_note(dir, std::move(pending));
+        }
+    }
+
+    void process_directory_slow(const fs::path& dir, int current_depth,
+                                PendingDir* collect) {
         uintmax_t total_size = 0;
         std::vector<std::pair<fs::path, uintmax_t>> entries;
 
+        uint64_t dir_start = profiling ? prof_now() : 0;
+        uint64_t stat_acc = 0;
+        uint64_t seen = 0;
+
         try {
             for (const auto& entry : fs::directory_iterator(dir)) {
+                seen++;
                 if (!should_process_file(entry.path())) {
                     continue;
                 }
 
-                if (fs::is_directory(entry)) {
-                    std::unique_lock<std::mutex> lock(queue_mutex);
-                    work_queue.push(entry.path());
-                    cv.notify_one();
-                } else if (fs::is_regular_file(entry)) {
-                    try {
-                        uintmax_t size = fs::file_size(entry);
-                        total_size += size;
-                        if (!summarize && size >= threshold) {
-                            entries.emplace_back(entry.path(), size);
+                // Classify from the symlink itself: following a link
+                // into an ancestor would make the walk cycle forever
+                // (the fast path already uses AT_SYMLINK_NOFOLLOW).
+                if (entry.is_directory() && !entry.is_symlink()) {
+                    if (collect) {
+                        collect->children.push_back(entry.path().filename().string());
+                    }
+                    enqueue_directory(entry.path(), current_depth + 1);
+                } else if (entry.is_regular_file() && !entry.is_symlink()) {
+                    uintmax_t size;
+                    uint64_t stat_start = profiling ? prof_now() : 0;
+                    if (dedupe_links) {
+                        struct statx stx;
+                        if (statx(AT_FDCWD, entry.path().c_str(),
+                                  AT_SYMLINK_NOFOLLOW,
+                                  STATX_SIZE | STATX_NLINK | STATX_INO,
+                                  &stx) != 0) {
+                            // Skip files that cannot be accessed
+                            continue;
+                        }
+                        if (stx.stx_nlink > 1 &&
+                            !linked_inodes.insert(make_dev(stx), stx.stx_ino)) {
+                            // Another link to this inode was already counted
+                            continue;
                         }
-                    } catch (const fs::filesystem_error&) {
-                        // Skip files that cannot be accessed
+                        size = stx.stx_size;
+                    } else {
+                        try {
+                            size = fs::file_size(entry);
+                        } catch (const fs::filesystem_error&) {
+                            // Skip files that cannot be accessed
+                            continue;
+                        }
+                    }
+                    if (profiling) {
+                        stat_acc += prof_now() - stat_start;
+                    }
+
+                    if (top_n > 0) {
+                        offer_top(entry.path(), size);
                         continue;
                     }
+                    total_size += size;
+                    if (!summarize && size >= threshold) {
+                        entries.emplace_back(entry.path(), size);
+                    }
                 }
             }
         } catch (const fs::filesystem_error&) {
@@ -122,46 +765,173 @@ private:
             return;
         }
 
-        {
-            std::lock_guard<std::mutex> lock(print_mutex);
-            dir_sizes[dir] = total_size;
-
-            if (!summarize) {
-                if (sort_output) {
-                    std::sort(entries.begin(), entries.end(),
-                        [](const auto& a, const auto& b) {
-                            return a.second > b.second;
-                        });
+        if (profiling) {
+            WorkerProfile& p = profiles[worker_index];
+            p.enumerate_ns += prof_now() - dir_start - stat_acc;
+            p.stat_ns += stat_acc;
+            p.entries += seen;
+            p.dirs++;
+        }
+
+        if (top_n == 0) {
+            record_directory(dir, total_size, entries);
+        }
+    }
+
+    // Fast traversal engine: enumerates with raw getdents64 into a large
+    // per-thread buffer, takes the entry type from d_type and only issues
+    // statx for entries whose size (or, on DT_UNKNOWN filesystems, type)
+    // is actually needed. This costs one openat + a handful of getdents64
+    // per directory instead of three to four syscalls per entry.
+    void process_directory_fast(const fs::path& dir, int current_depth,
+                                PendingDir* collect) {
+        int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
+        if (fd < 0) {
+            // Skip directories that cannot be accessed
+            return;
+        }
+
+        static thread_local std::vector<char> dent_buf(256 * 1024);
+        static thread_local std::vector<std::string> stat_batch;
+        stat_batch.clear();
+
+        uintmax_t total_size = 0;
+        std::vector<std::pair<fs::path, uintmax_t>> entries;
+
+        // The fast path has clean stage boundaries: the getdents loop is
+        // enumeration, the batch below is stat — two clock pairs per
+        // directory, not per entry.
+        uint64_t enum_start = profiling ? prof_now() : 0;
+        uint64_t seen = 0;
+
+        for (;;) {
+            long n = syscall(SYS_getdents64, fd, dent_buf.data(), dent_buf.size());
+            if (n <= 0) {
+                break;
+            }
+
+            for (long off = 0; off < n;) {
+                auto* d = reinterpret_cast<struct dirent64*>(dent_buf.data() + off);
+                off += d->d_reclen;
+                seen++;
+
+                const char* name = d->d_name;
+                if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) {
+                    continue;
+                }
+                if (!show_all && name[0] == '.') {
+                    continue;
                 }
 
-                for (const auto& entry : entries) {
-                    if (entry.second >= threshold) {
-                        std::cout << std::setw(15) << format_size(entry.second, human_readable)
-                                << "  " << entry.first.filename().string() << std::endl;
+                unsigned char type = d->d_type;
+                if (type == DT_UNKNOWN) {
+                    // Filesystem without d_type support; fall back to statx
+                    struct statx stx;
+                    if (statx(fd, name, AT_SYMLINK_NOFOLLOW, STATX_TYPE, &stx) != 0) {
+                        continue;
+                    }
+                    if (S_ISDIR(stx.stx_mode)) {
+                        type = DT_DIR;
+                    } else if (S_ISREG(stx.stx_mode)) {
+                        type = DT_REG;
                     }
                 }
+
+                if (type == DT_DIR) {
+                    if (collect) {
+                        collect->children.emplace_back(name);
+                    }
+                    enqueue_directory(dir / name, current_depth + 1);
+                } else if (type == DT_REG) {
+                    stat_batch.emplace_back(name);
+                }
             }
         }
+
+        uint64_t stat_start = profiling ? prof_now() : 0;
+
+        // Resolve the sizes of regular files in one pass over the batch,
+        // relative to the still-open directory fd (no path re-resolution).
+        unsigned int stat_mask = STATX_SIZE;
+        if (dedupe_links) {
+            stat_mask |= STATX_NLINK | STATX_INO;
+        }
+        for (const auto& name : stat_batch) {
+            struct statx stx;
+            if (statx(fd, name.c_str(), AT_SYMLINK_NOFOLLOW, stat_mask, &stx) != 0) {
+                // Skip files that cannot be accessed
+                continue;
+            }
+            if (dedupe_links && stx.stx_nlink > 1 &&
+                !linked_inodes.insert(make_dev(stx), stx.stx_ino)) {
+                // Another link to this inode was already counted
+                continue;
+            }
+            uintmax_t size = stx.stx_size;
+            if (top_n > 0) {
+                offer_top(dir / name, size);
+                continue;
+            }
+            total_size += size;
+            if (!summarize && size >= threshold) {
+                entries.emplace_back(dir / name, size);
+            }
+        }
+
+        close(fd);
+
+        if (profiling) {
+            WorkerProfile& p = profiles[worker_index];
+            p.enumerate_ns += stat_start - enum_start;
+            p.stat_ns += prof_now() - stat_start;
+            p.entries += seen;
+            p.dirs++;
+        }
+
+        if (top_n == 0) {
+            record_directory(dir, total_size, entries);
+        }
     }
 
-    void worker_thread() {
+    // Workers drain their own deque first and steal from the others when
+    // it runs dry. pending_work counts items that have been enqueued but
+    // not yet fully processed (including their chance to enqueue children),
+    // so a worker may only exit once it observes zero — the old
+    // processing_complete flag could be raised while children were still
+    // being discovered.
+    void worker_thread(int id) {
+        worker_index = id;
+        int idle_spins = 0;
+
         while (true) {
-            fs::path dir_path;
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex);
-                cv.wait(lock, [this] { 
-                    return !work_queue.empty() || processing_complete; 
-                });
+            WorkItem* item = deques[id]->pop();
 
-                if (processing_complete && work_queue.empty()) {
-                    break;
+            if (!item) {
+                int n = static_cast<int>(deques.size());
+                for (int v = 1; v < n && !item; ++v) {
+                    item = deques[(id + v) % n]->steal();
                 }
-
-                dir_path = work_queue.front();
-                work_queue.pop();
             }
 
-            process_directory(dir_path, 0);
+            if (item) {
+                process_directory(item->path, item->depth);
+                delete item;
+                pending_work.fetch_sub(1, std::memory_order_release);
+                idle_spins = 0;
+            } else {
+                if (pending_work.load(std::memory_order_acquire) == 0) {
+                    break;
+                }
+                uint64_t idle_start = profiling ? prof_now() : 0;
+                if (++idle_spins < 64) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+                if (profiling) {
+                    profiles[id].idle_ns += prof_now() - idle_start;
+                }
+            }
         }
     }
 
@@ -173,7 +943,8 @@ public:
         threshold(0),
         human_readable(false),
         sort_output(true),
-        thread_count(4) {}
+        thread_count(4),
+        fast_mode(false) {}
 
     void set_show_all(bool value) { show_all = value; }
     void set_summarize(bool value) { summarize = value; }
@@ -181,60 +952,153 @@ public:
     void set_threshold(size_t value) { threshold = value * 1024; } // Convert KB to bytes
     void set_human_readable(bool value) { human_readable = value; }
     void set_sort_output(bool value) { sort_output = value; }
-    void set_thread_count(int value) { 
+    void set_thread_count(int value) {
         if (value > 0) thread_count = value;
     }
+    void set_fast_mode(bool value) { fast_mode = value; }
+    void set_cache_file(const std::string& value) { cache_file = value; }
+    void set_top_n(size_t value) { top_n = value; }
+    void set_dedupe_links(bool value) { dedupe_links = value; }
+    void set_profiling(bool value) { profiling = value; }
 
     void process(const std::vector<std::string>& paths) {
         std::vector<std::thread> threads;
         std::vector<fs::path> directories;
 
-        // If no paths were given, use the current directory
+        // If no paths were given, use the current directory. Roots are
+        // normalized so "dir/" and "dir" key identically — the
+        // aggregation pass matches children to parents by string, and a
+        // trailing separator on a root would orphan its whole subtree.
         if (paths.empty()) {
             directories.push_back(fs::current_path());
         } else {
             for (const auto& path : paths) {
                 if (fs::exists(path)) {
-                    directories.push_back(fs::absolute(path));
+                    fs::path root = fs::absolute(path).lexically_normal();
+                    if (!root.has_filename()) {
+                        // lexically_normal keeps a trailing separator
+                        root = root.parent_path();
+                    }
+                    directories.push_back(std::move(root));
                 } else {
                     std::cerr << "Warning: path does not exist: " << path << std::endl;
                 }
             }
         }
 
-        // Start worker threads
-        for (int i = 0; i < thread_count; ++i) {
-            threads.emplace_back(&DirSize::worker_thread, this);
+        if (!cache_file.empty() && top_n == 0 && !dedupe_links) {
+            load_cache();
         }
 
-        // Enqueue the initial directories
+        // One deque per worker; seed the first with the initial
+        // directories before any worker starts stealing
+        for (int i = 0; i < thread_count; ++i) {
+            deques.emplace_back(std::make_unique<WorkStealingDeque>());
+        }
         for (const auto& dir : directories) {
-            work_queue.push(dir);
+            enqueue_directory(dir, 0);
         }
 
-        // Signal that all directories have been submitted
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            processing_complete = true;
+        if (profiling) {
+            profiles.assign(static_cast<size_t>(thread_count), WorkerProfile{});
+        }
+        uint64_t wall_start = profiling ? prof_now() : 0;
+
+        // Start worker threads
+        for (int i = 0; i < thread_count; ++i) {
+            threads.emplace_back(&DirSize::worker_thread, this, i);
         }
-        cv.notify_all();
 
         // Wait for all threads to finish
         for (auto& thread : threads) {
             thread.join();
         }
 
+        // Each worker only ever touched its own profiles slot, so after
+        // the join the merged picture is just a read — no locking during
+        // the run, no synchronization here beyond the joins themselves.
+        if (profiling) {
+            print_profile(prof_now() - wall_start);
+        }
+
+        if (!cache_file.empty() && top_n == 0 && !dedupe_links) {
+            save_cache();
+            if (cache_map) {
+                munmap(cache_map, cache_map_len);
+                cache_map = nullptr;
+                cache_records = nullptr;
+                cache_record_count = 0;
+            }
+        }
+
         // Print results
+        if (top_n > 0) {
+            std::vector<std::pair<uintmax_t, fs::path>> top;
+            top.reserve(top_heap.size());
+            while (!top_heap.empty()) {
+                top.push_back(top_heap.top());
+                top_heap.pop();
+            }
+            std::sort(top.begin(), top.end(),
+                [](const auto& a, const auto& b) {
+                    return a.first > b.first;
+                });
+
+            list_out.write("\nLargest files:\n");
+            for (const auto& [size, path] : top) {
+                put_size_field(list_out, size, human_readable);
+                list_out.write("  ");
+                list_out.write(path.string());
+                list_out.put('\n');
+            }
+            list_out.flush();
+            return;
+        }
+
         if (summarize || !directories.empty()) {
+            // Build the aggregation tree: dir_sizes is path-sorted, so a
+            // parent is always inserted before its children and each
+            // parent lookup is a single hash probe instead of a prefix
+            // scan over every directory.
+            struct Node {
+                const fs::path* path;
+                long parent;
+                int depth;
+                uintmax_t total;
+            };
+            std::vector<Node> nodes;
+            nodes.reserve(dir_sizes.size());
+            std::unordered_map<std::string, size_t> node_index;
+            node_index.reserve(dir_sizes.size());
+
+            for (const auto& [path, size] : dir_sizes) {
+                long parent = -1;
+                int depth = 0;
+                auto it = node_index.find(path.parent_path().string());
+                if (it != node_index.end()) {
+                    parent = static_cast<long>(it->second);
+                    depth = nodes[it->second].depth + 1;
+                }
+                node_index.emplace(path.string(), nodes.size());
+                nodes.push_back(Node{&path, parent, depth, size});
+            }
+
+            // A child always sits after its parent, so one reverse pass
+            // rolls every subtree total up to the roots in O(N).
+            for (size_t i = nodes.size(); i-- > 0;) {
+                if (nodes[i].parent >= 0) {
+                    nodes[nodes[i].parent].total += nodes[i].total;
+                }
+            }
+
+            // With -s and an explicit -d, report subtotals down to that
+            // depth; otherwise only the requested roots, as before.
+            int report_depth = (summarize && max_depth != -1) ? max_depth : 0;
             std::vector<std::pair<fs::path, uintmax_t>> results;
-            for (const auto& dir : directories) {
-                uintmax_t total = 0;
-                for (const auto& [path, size] : dir_sizes) {
-                    if (path.string().find(dir.string()) == 0) {
-                        total += size;
-                    }
+            for (const auto& node : nodes) {
+                if (node.depth <= report_depth) {
+                    results.emplace_back(*node.path, node.total);
                 }
-                results.emplace_back(dir, total);
             }
 
             if (sort_output) {
@@ -244,17 +1108,22 @@ public:
                     });
             }
 
-            std::cout << "\nDirectory sizes:" << std::endl;
+            list_out.write("\nDirectory sizes:\n");
             for (const auto& [path, size] : results) {
                 if (size >= threshold) {
-                    std::cout << std::setw(15) << format_size(size, human_readable)
-                            << "  " << path.string() << std::endl;
+                    put_size_field(list_out, size, human_readable);
+                    list_out.write("  ");
+                    list_out.write(path.string());
+                    list_out.put('\n');
                 }
             }
         }
+        list_out.flush();
     }
 };
 
+thread_local int DirSize::worker_index = 0;
+
 int main(int argc, char* argv[]) {
     try {
         std::vector<std::string> args(argv + 1, argv + argc);
@@ -279,13 +1148,13 @@ int main(int argc, char* argv[]) {
                 if (i >= args.size()) {
                     throw std::runtime_error("--depth requires a number");
                 }
-                calculator.set_max_depth(std::stoi(args[i++]));
+                calculator.set_max_depth(static_cast<int>(advbox::to_i64(args[i++], "depth")));
             }
             else if (arg == "-t" || arg == "--threshold") {
                 if (i >= args.size()) {
                     throw std::runtime_error("--threshold requires a number");
                 }
-                calculator.set_threshold(std::stoull(args[i++]));
+                calculator.set_threshold(static_cast<uintmax_t>(advbox::to_i64(args[i++], "threshold")));
             }
             else if (arg == "-u" || arg == "--human") {
                 calculator.set_human_readable(true);
@@ -293,11 +1162,32 @@ int main(int argc, char* argv[]) {
             else if (arg == "--no-sort") {
                 calculator.set_sort_output(false);
             }
+            else if (arg == "--fast") {
+                calculator.set_fast_mode(true);
+            }
+            else if (arg == "--cache") {
+                if (i >= args.size()) {
+                    throw std::runtime_error("--cache requires a file");
+                }
+                calculator.set_cache_file(args[i++]);
+            }
+            else if (arg == "--dedupe-links") {
+                calculator.set_dedupe_links(true);
+            }
+            else if (arg == "--profile") {
+                calculator.set_profiling(true);
+            }
+            else if (arg == "--top") {
+                if (i >= args.size()) {
+                    throw std::runtime_error("--top requires a number");
+                }
+                calculator.set_top_n(static_cast<size_t>(advbox::to_i64(args[i++], "count")));
+            }
             else if (arg == "--threads") {
                 if (i >= args.size()) {
                     throw std::runtime_error("--threads requires a number");
                 }
-                calculator.set_thread_count(std::stoi(args[i++]));
+                calculator.set_thread_count(static_cast<int>(advbox::to_i64(args[i++], "thread count")));
             }
             else if (arg[0] == '-') {
                 throw std::runtime_error("Unknown option: " + arg);
@@ -1,7 +1,8 @@
 use std::env;
 use std::process::{Command, Stdio};
+use std::sync::mpsc;
+use std::thread;
 use std::time::{Duration, Instant};
-use std::collections::VecDeque;
 use std::io::{self, Write};
 
 const HELP: &str = r#"
@@ -13,14 +14,22 @@ Usage:
 Options:
     -n, --iterations <N>    Number of iterations for averaging (default: 3)
     -w, --warmup <N>        Number of warmup runs (default: 1)
+    -c, --concurrency <N>   Run N command instances simultaneously;
+                            each worker performs its own warmup and
+                            iterations (default: 1)
     -q, --quiet            Quiet mode - only show final results
     -s, --simple           Simple output format
     -h, --help             Show this help message
 
+Statistics are streamed (constant memory): mean and variance online,
+p50/p95/p99 via P-square quantile estimators, so million-iteration
+runs are fine. Warmup runs are excluded from all numbers.
+
 Example:
     estimate -n 5 ls -la
     estimate -w 2 -n 3 find . -type f
     estimate -s "sleep 1"
+    estimate -c 8 -n 100 curl -s localhost:8080/health
 
 Note: Use quotes for commands with arguments
 "#;
@@ -29,38 +38,157 @@ Note: Use quotes for commands with arguments
 struct Config {
     iterations: usize,
     warmup: usize,
+    concurrency: usize,
     quiet: bool,
     simple: bool,
     command: String,
     args: Vec<String>,
 }
 
-#[derive(Debug)]
+/// P-square single-quantile estimator (Jain & Chlamtac): tracks one
+/// quantile with five markers in constant memory, no stored samples.
+#[derive(Debug, Clone)]
+struct P2Quantile {
+    p: f64,
+    heights: [f64; 5],
+    positions: [f64; 5],
+    desired: [f64; 5],
+    increments: [f64; 5],
+    count: usize,
+}
+
+impl P2Quantile {
+    fn new(p: f64) -> Self {
+        P2Quantile {
+            p,
+            heights: [0.0; 5],
+            positions: [1.0, 2.0, 3.0, 4.0, 5.0],
+            desired: [1.0, 1.0 + 2.0 * p, 1.0 + 4.0 * p, 3.0 + 2.0 * p, 5.0],
+            increments: [0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0],
+            count: 0,
+        }
+    }
+
+    fn insert(&mut self, x: f64) {
+        if self.count < 5 {
+            self.heights[self.count] = x;
+            self.count += 1;
+            if self.count == 5 {
+                self.heights.sort_by(|a, b| a.partial_cmp(b).unwrap());
+            }
+            return;
+        }
+        self.count += 1;
+
+        // Find the cell and stretch the extreme markers.
+        let k = if x < self.heights[0] {
+            self.heights[0] = x;
+            0
+        } else if x >= self.heights[4] {
+            self.heights[4] = x;
+            3
+        } else {
+            let mut k = 0;
+            while x >= self.heights[k + 1] {
+                k += 1;
+            }
+            k
+        };
+
+        for i in (k + 1)..5 {
+            self.positions[i] += 1.0;
+        }
+        for i in 0..5 {
+            self.desired[i] += self.increments[i];
+        }
+
+        // Adjust the three middle markers toward their desired
+        // positions, parabolic when possible, linear otherwise.
+        for i in 1..4 {
+            let d = self.desired[i] - self.positions[i];
+            if (d >= 1.0 && self.positions[i + 1] - self.positions[i] > 1.0)
+                || (d <= -1.0 && self.positions[i - 1] - self.positions[i] < -1.0)
+            {
+                let d = d.signum();
+                let q = self.parabolic(i, d);
+                self.heights[i] = if self.heights[i - 1] < q && q < self.heights[i + 1] {
+                    q
+                } else {
+                    self.linear(i, d)
+                };
+                self.positions[i] += d;
+            }
+        }
+    }
+
+    fn parabolic(&self, i: usize, d: f64) -> f64 {
+        let q = &self.heights;
+        let n = &self.positions;
+        q[i] + d / (n[i + 1] - n[i - 1])
+            * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+                + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]))
+    }
+
+    fn linear(&self, i: usize, d: f64) -> f64 {
+        let j = if d > 0.0 { i + 1 } else { i - 1 };
+        self.heights[i]
+            + d * (self.heights[j] - self.heights[i]) / (self.positions[j] - self.positions[i])
+    }
+
+    fn value(&self) -> f64 {
+        if self.count == 0 {
+            return 0.0;
+        }
+        if self.count >= 5 {
+            return self.heights[2];
+        }
+        // Too few samples for the sketch: interpolate over what we have.
+        let mut sorted = self.heights;
+        let slice = &mut sorted[..self.count];
+        slice.sort_by(|a, b| a.partial_cmp(b).unwrap());
+        let rank = self.p * (self.count - 1) as f64;
+        let lo = rank.floor() as usize;
+        let hi = rank.ceil() as usize;
+        slice[lo] + (slice[hi] - slice[lo]) * (rank - lo as f64)
+    }
+}
+
+/// Streaming execution statistics: Welford mean/variance plus three
+/// P-square sketches. Constant memory regardless of iteration count.
+#[derive(Debug, Clone)]
 struct ExecutionStats {
-    times: VecDeque<Duration>,
+    count: usize,
+    success_count: usize,
+    fail_count: usize,
     min: Duration,
     max: Duration,
-    avg: Duration,
     total_time: Duration,
-    success_count: usize,
-    fail_count: usize,
+    mean: f64, // seconds
+    m2: f64,
+    p50: P2Quantile,
+    p95: P2Quantile,
+    p99: P2Quantile,
 }
 
 impl ExecutionStats {
     fn new() -> Self {
         ExecutionStats {
-            times: VecDeque::new(),
+            count: 0,
+            success_count: 0,
+            fail_count: 0,
             min: Duration::from_secs(0),
             max: Duration::from_secs(0),
-            avg: Duration::from_secs(0),
             total_time: Duration::from_secs(0),
-            success_count: 0,
-            fail_count: 0,
+            mean: 0.0,
+            m2: 0.0,
+            p50: P2Quantile::new(0.50),
+            p95: P2Quantile::new(0.95),
+            p99: P2Quantile::new(0.99),
         }
     }
 
     fn add_execution(&mut self, duration: Duration, success: bool) {
-        self.times.push_back(duration);
+        self.count += 1;
         self.total_time += duration;
 
         if success {
@@ -69,16 +197,36 @@ impl ExecutionStats {
             self.fail_count += 1;
         }
 
-        // Update statistics
-        if self.times.len() == 1 || duration < self.min {
+        if self.count == 1 || duration < self.min {
             self.min = duration;
         }
-        if self.times.len() == 1 || duration > self.max {
+        if self.count == 1 || duration > self.max {
             self.max = duration;
         }
 
-        // Recalculate the average
-        self.avg = self.total_time / self.times.len() as u32;
+        let x = duration.as_secs_f64();
+        let delta = x - self.mean;
+        self.mean += delta / self.count as f64;
+        self.m2 += delta * (x - self.mean);
+
+        self.p50.insert(x);
+        self.p95.insert(x);
+        self.p99.insert(x);
+    }
+
+    fn avg(&self) -> Duration {
+        Duration::from_secs_f64(self.mean.max(0.0))
+    }
+
+    fn stddev(&self) -> Duration {
+        if self.count < 2 {
+            return Duration::from_secs(0);
+        }
+        Duration::from_secs_f64((self.m2 / (self.count - 1) as f64).sqrt())
+    }
+
+    fn quantile(&self, which: &P2Quantile) -> Duration {
+        Duration::from_secs_f64(which.value().max(0.0))
     }
 }
 
@@ -92,6 +240,7 @@ fn parse_args() -> Result<Config, String> {
     let mut config = Config {
         iterations: 3,
         warmup: 1,
+        concurrency: 1,
         quiet: false,
         simple: false,
         command: String::new(),
@@ -124,6 +273,17 @@ fn parse_args() -> Result<Config, String> {
                 config.warmup = args[i].parse()
                     .map_err(|_| "Invalid warmup value")?;
             }
+            "-c" | "--concurrency" => {
+                i += 1;
+                if i >= args.len() {
+                    return Err("Missing value for concurrency".to_string());
+                }
+                config.concurrency = args[i].parse()
+                    .map_err(|_| "Invalid concurrency value")?;
+                if config.concurrency < 1 {
+                    return Err("Concurrency must be at least 1".to_string());
+                }
+            }
             "-q" | "--quiet" => {
                 config.quiet = true;
             }
@@ -175,27 +335,62 @@ fn print_progress(current: usize, total: usize) {
     io::stdout().flush().unwrap();
 }
 
-fn print_results(stats: &ExecutionStats, config: &Config) {
+fn print_results(stats: &ExecutionStats, config: &Config, per_worker: &[ExecutionStats],
+                 wall_time: Option<Duration>) {
     if config.simple {
-        println!("min={} max={} avg={} total={} success={} fail={}",
+        println!("min={} max={} avg={} stddev={} p50={} p95={} p99={} total={} success={} fail={}",
             format_duration(stats.min),
             format_duration(stats.max),
-            format_duration(stats.avg),
+            format_duration(stats.avg()),
+            format_duration(stats.stddev()),
+            format_duration(stats.quantile(&stats.p50)),
+            format_duration(stats.quantile(&stats.p95)),
+            format_duration(stats.quantile(&stats.p99)),
             format_duration(stats.total_time),
             stats.success_count,
             stats.fail_count
         );
-    } else {
-        println!("\n=== Execution Summary ===");
-        println!("Command: {} {}", config.command, config.args.join(" "));
-        println!("Iterations: {}", stats.times.len());
-        println!("Successful: {}", stats.success_count);
-        println!("Failed: {}", stats.fail_count);
-        println!("\nTimings:");
-        println!("  Minimum: {}", format_duration(stats.min));
-        println!("  Maximum: {}", format_duration(stats.max));
-        println!("  Average: {}", format_duration(stats.avg));
-        println!("  Total:   {}", format_duration(stats.total_time));
+        return;
+    }
+
+    println!("\n=== Execution Summary ===");
+    println!("Command: {} {}", config.command, config.args.join(" "));
+    println!("Iterations: {}", stats.count);
+    if config.concurrency > 1 {
+        println!("Concurrency: {}", config.concurrency);
+    }
+    println!("Successful: {}", stats.success_count);
+    println!("Failed: {}", stats.fail_count);
+    println!("\nTimings:");
+    println!("  Minimum: {}", format_duration(stats.min));
+    println!("  Maximum: {}", format_duration(stats.max));
+    println!("  Average: {}", format_duration(stats.avg()));
+    println!("  StdDev:  {}", format_duration(stats.stddev()));
+    println!("  P50:     {}", format_duration(stats.quantile(&stats.p50)));
+    println!("  P95:     {}", format_duration(stats.quantile(&stats.p95)));
+    println!("  P99:     {}", format_duration(stats.quantile(&stats.p99)));
+    println!("  Total:   {}", format_duration(stats.total_time));
+
+    if let Some(wall) = wall_time {
+        let secs = wall.as_secs_f64();
+        if secs > 0.0 {
+            println!("\nThroughput: {:.1} runs/s over {} of wall time",
+                stats.count as f64 / secs, format_duration(wall));
+        }
+    }
+
+    if per_worker.len() > 1 {
+        println!("\nPer-worker latencies:");
+        for (i, w) in per_worker.iter().enumerate() {
+            println!("  Worker {:2}: n={} avg={} p50={} p95={} p99={} fail={}",
+                i,
+                w.count,
+                format_duration(w.avg()),
+                format_duration(w.quantile(&w.p50)),
+                format_duration(w.quantile(&w.p95)),
+                format_duration(w.quantile(&w.p99)),
+                w.fail_count);
+        }
     }
 }
 
@@ -210,6 +405,11 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
     };
 
     let total_runs = config.warmup + config.iterations;
+
+    if config.concurrency > 1 {
+        return run_concurrent(&config);
+    }
+
     let mut stats = ExecutionStats::new();
 
     if !config.quiet {
@@ -241,7 +441,73 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         println!();
     }
 
-    print_results(&stats, &config);
+    print_results(&stats, &config, &[], None);
+
+    Ok(())
+}
+
+/// Throughput mode: N workers each run their own warmup plus the
+/// configured iterations simultaneously. Post-warmup samples stream
+/// through a channel into one aggregate sketch; per-worker sketches
+/// come back when the workers join.
+fn run_concurrent(config: &Config) -> Result<(), Box<dyn std::error::Error>> {
+    if !config.quiet {
+        println!("Running '{}' under {} concurrent workers ({} iterations + {} warmup each)...",
+                config.command,
+                config.concurrency,
+                config.iterations,
+                config.warmup);
+    }
+
+    let (tx, rx) = mpsc::channel::<(Duration, bool)>();
+    let mut handles = Vec::new();
+    let started = Instant::now();
 
+    for _ in 0..config.concurrency {
+        let tx = tx.clone();
+        let command = config.command.clone();
+        let args = config.args.clone();
+        let warmup = config.warmup;
+        let iterations = config.iterations;
+        handles.push(thread::spawn(move || {
+            let mut local = ExecutionStats::new();
+            for i in 0..(warmup + iterations) {
+                match run_command(&command, &args) {
+                    Ok((duration, success)) => {
+                        if i >= warmup {
+                            local.add_execution(duration, success);
+                            let _ = tx.send((duration, success));
+                        }
+                    }
+                    Err(_) => {
+                        // Spawn failure counts as a failed run.
+                        if i >= warmup {
+                            local.add_execution(Duration::from_secs(0), false);
+                            let _ = tx.send((Duration::from_secs(0), false));
+                        }
+                    }
+                }
+            }
+            local
+        }));
+    }
+    drop(tx);
+
+    let mut aggregate = ExecutionStats::new();
+    for (duration, success) in rx {
+        aggregate.add_execution(duration, success);
+    }
+    let wall_time = started.elapsed();
+
+    let mut per_worker = Vec::new();
+    for handle in handles {
+        per_worker.push(handle.join().expect("worker panicked"));
+    }
+
+    print_results(&aggregate, config, &per_worker, Some(wall_time));
+
+    if aggregate.count == aggregate.fail_count && aggregate.count > 0 {
+        std::process::exit(1);
+    }
     Ok(())
 }
\ No newline at end of file
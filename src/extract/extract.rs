@@ -1,42 +1,55 @@
+use std::collections::HashMap;
 use std::env;
-use std::path::{Path, PathBuf};
-use std::process::{Command, exit};
 use std::fs;
+use std::path::{Path, PathBuf};
+use std::process::{Command, Stdio, exit};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex};
+use std::thread;
 
 const HELP: &str = r#"
 Extract - Universal archive extractor
 
 Usage:
-    extract [OPTIONS] <archive> [destination]
+    extract [OPTIONS] <archive>... [destination]
 
 Options:
     -l, --list       List contents without extracting
     -f, --force      Overwrite existing files
     -q, --quiet      Suppress output except errors
     -k, --keep       Keep archive after extraction
+    -d, --dest <DIR> Destination directory
+    -j, --jobs <N>   Max concurrent extractions (default: CPU count)
     -h, --help       Show this help message
 
 Supported formats:
     .zip, .tar, .tar.gz, .tgz, .tar.bz2, .tbz2,
     .tar.xz, .txz, .tar.zst, .7z, .rar
 
+Multiple archives are unpacked concurrently up to the --jobs limit.
+For compressed tarballs the decompressor is piped straight into tar,
+so nothing is staged in a temp file. A trailing non-existent path is
+treated as the destination, as before.
+
 Examples:
     extract archive.zip
     extract -l backup.tar.gz
     extract data.7z /path/to/dest
+    extract -j 8 batch/*.tar.zst -d /srv/ingest
 "#;
 
 #[derive(Debug)]
 struct Config {
-    archive_path: PathBuf,
+    archives: Vec<PathBuf>,
     destination: Option<PathBuf>,
+    jobs: usize,
     list_only: bool,
     force: bool,
     quiet: bool,
     keep: bool,
 }
 
-#[derive(Debug)]
+#[derive(Debug, Clone, Copy, PartialEq)]
 enum ArchiveType {
     Zip,
     Tar,
@@ -54,11 +67,11 @@ impl ArchiveType {
         let ext = path.extension()
             .and_then(|e| e.to_str())
             .unwrap_or("");
-        
+
         let name = path.file_name()
             .and_then(|n| n.to_str())
             .unwrap_or("");
-        
+
         match (name.to_lowercase().as_str(), ext.to_lowercase().as_str()) {
             (n, _) if n.ends_with(".tar.gz") => ArchiveType::TarGz,
             (n, _) if n.ends_with(".tar.bz2") => ArchiveType::TarBz2,
@@ -74,7 +87,7 @@ impl ArchiveType {
             _ => ArchiveType::Unknown,
         }
     }
-    
+
     fn get_command(&self) -> Option<(&'static str, Vec<&'static str>)> {
         match self {
             ArchiveType::Zip => Some(("unzip", vec!["-q"])),
@@ -88,7 +101,7 @@ impl ArchiveType {
             ArchiveType::Unknown => None,
         }
     }
-    
+
     fn get_list_command(&self) -> Option<(&'static str, Vec<&'static str>)> {
         match self {
             ArchiveType::Zip => Some(("unzip", vec!["-l"])),
@@ -102,115 +115,255 @@ impl ArchiveType {
             ArchiveType::Unknown => None,
         }
     }
+
+    /// Standalone decompressor for the compressed-tarball formats,
+    /// used to stream into tar rather than letting tar re-exec one.
+    fn decompressor(&self) -> Option<&'static str> {
+        match self {
+            ArchiveType::TarGz => Some("gzip"),
+            ArchiveType::TarBz2 => Some("bzip2"),
+            ArchiveType::TarXz => Some("xz"),
+            ArchiveType::TarZst => Some("zstd"),
+            _ => None,
+        }
+    }
 }
 
-fn check_command_exists(command: &str) -> bool {
-    Command::new("which")
-        .arg(command)
-        .output()
-        .map(|output| output.status.success())
-        .unwrap_or(false)
+/// Executable lookup by scanning PATH directly — no `which` subprocess.
+fn find_in_path(command: &str) -> bool {
+    let path = match env::var_os("PATH") {
+        Some(p) => p,
+        None => return false,
+    };
+    for dir in env::split_paths(&path) {
+        let candidate = dir.join(command);
+        if let Ok(metadata) = fs::metadata(&candidate) {
+            if metadata.is_file() {
+                use std::os::unix::fs::PermissionsExt;
+                if metadata.permissions().mode() & 0o111 != 0 {
+                    return true;
+                }
+            }
+        }
+    }
+    false
+}
+
+/// Capability table: every tool the batch might need, probed once at
+/// startup instead of one `which` subprocess per archive.
+fn probe_tools(archives: &[PathBuf]) -> HashMap<&'static str, bool> {
+    let mut tools: Vec<&'static str> = Vec::new();
+    for path in archives {
+        let archive_type = ArchiveType::from_path(path);
+        if let Some((cmd, _)) = archive_type.get_command() {
+            tools.push(cmd);
+        }
+        if let Some(dc) = archive_type.decompressor() {
+            tools.push(dc);
+        }
+    }
+    tools.sort();
+    tools.dedup();
+    tools.into_iter().map(|t| (t, find_in_path(t))).collect()
 }
 
-fn extract_archive(config: &Config) -> Result<(), String> {
-    let archive_type = ArchiveType::from_path(&config.archive_path);
-    
-    match archive_type {
-        ArchiveType::Unknown => {
-            return Err("Unsupported archive format".to_string());
+/// Run `<decompressor> -dc archive | tar -xf -` (or -tf for listing),
+/// streamed through a pipe with no intermediate file.
+fn run_tar_pipeline(
+    archive: &Path,
+    decomp: &str,
+    config: &Config,
+) -> Result<String, String> {
+    let mut dc_child = Command::new(decomp)
+        .args(&["-dc"])
+        .arg(archive)
+        .stdout(Stdio::piped())
+        .stderr(Stdio::piped())
+        .spawn()
+        .map_err(|e| format!("Failed to start {}: {}", decomp, e))?;
+
+    let dc_stdout = dc_child.stdout.take()
+        .ok_or_else(|| "Failed to open decompressor pipe".to_string())?;
+
+    let mut tar = Command::new("tar");
+    tar.arg(if config.list_only { "-tf" } else { "-xf" })
+        .arg("-")
+        .stdin(Stdio::from(dc_stdout));
+    if !config.list_only {
+        if let Some(ref dest) = config.destination {
+            tar.current_dir(dest);
         }
-        _ => {
-            if let Some((cmd, base_args)) = if config.list_only {
-                archive_type.get_list_command()
-            } else {
-                archive_type.get_command()
-            } {
-                if !check_command_exists(cmd) {
-                    return Err(format!("Required command '{}' not found", cmd));
+    }
+
+    let output = tar.output()
+        .map_err(|e| format!("Failed to execute tar: {}", e))?;
+    let dc_status = dc_child.wait()
+        .map_err(|e| format!("Failed to wait for {}: {}", decomp, e))?;
+
+    if !dc_status.success() {
+        let mut err = String::new();
+        if let Some(mut stderr) = dc_child.stderr.take() {
+            use std::io::Read;
+            let _ = stderr.read_to_string(&mut err);
+        }
+        return Err(format!("Decompression failed: {}", err.trim()));
+    }
+    if !output.status.success() {
+        return Err(format!("Extraction failed: {}",
+            String::from_utf8_lossy(&output.stderr)));
+    }
+    Ok(String::from_utf8_lossy(&output.stdout).into_owned())
+}
+
+/// Extract or list a single archive. Returns the captured output to
+/// print, so concurrent jobs don't interleave mid-archive.
+fn extract_archive(
+    archive: &Path,
+    config: &Config,
+    tools: &HashMap<&'static str, bool>,
+) -> Result<String, String> {
+    let archive_type = ArchiveType::from_path(archive);
+
+    let (cmd, base_args) = match if config.list_only {
+        archive_type.get_list_command()
+    } else {
+        archive_type.get_command()
+    } {
+        Some(c) => c,
+        None => return Err("Unsupported archive format".to_string()),
+    };
+
+    if !tools.get(cmd).copied().unwrap_or(false) {
+        return Err(format!("Required command '{}' not found", cmd));
+    }
+
+    let stdout;
+    if let Some(decomp) = archive_type.decompressor()
+        .filter(|dc| tools.get(dc).copied().unwrap_or(false)) {
+        // Streamed path for tar.{gz,bz2,xz,zst}.
+        stdout = run_tar_pipeline(archive, decomp, config)?;
+    } else {
+        let mut command = Command::new(cmd);
+        command.args(base_args);
+
+        // Add format-specific options
+        match cmd {
+            "unzip" => {
+                if config.force {
+                    command.arg("-o");
                 }
-                
-                let mut command = Command::new(cmd);
-                command.args(base_args);
-                
-                // Add format-specific options
-                match cmd {
-                    "unzip" => {
-                        if config.force {
-                            command.arg("-o");
-                        }
-                        if config.quiet {
-                            command.arg("-qq");
-                        }
-                    }
-                    "7z" => {
-                        if config.quiet {
-                            command.arg("-bd");
-                        }
-                        if config.force {
-                            command.arg("-y");
-                        }
-                    }
-                    "unrar" => {
-                        if config.force {
-                            command.arg("-o+");
-                        }
-                        if config.quiet {
-                            command.arg("-inul");
-                        }
-                    }
-                    _ => {}
+                if config.quiet {
+                    command.arg("-qq");
                 }
-                
-                command.arg(&config.archive_path);
-                
-                if !config.list_only {
-                    if let Some(ref dest) = config.destination {
-                        // Create the destination directory if it does not exist
-                        fs::create_dir_all(dest)
-                            .map_err(|e| format!("Failed to create destination directory: {}", e))?;
-                        
-                        command.current_dir(dest);
-                    }
+            }
+            "7z" => {
+                if config.quiet {
+                    command.arg("-bd");
                 }
-                
-                let output = command
-                    .output()
-                    .map_err(|e| format!("Failed to execute command: {}", e))?;
-                
-                if !output.status.success() {
-                    return Err(format!("Extraction failed: {}", 
-                        String::from_utf8_lossy(&output.stderr)));
+                if config.force {
+                    command.arg("-y");
                 }
-                
-                if !config.quiet {
-                    println!("{}", String::from_utf8_lossy(&output.stdout));
+            }
+            "unrar" => {
+                if config.force {
+                    command.arg("-o+");
                 }
-                
-                // Remove the archive unless the keep flag is set
-                if !config.keep && !config.list_only {
-                    fs::remove_file(&config.archive_path)
-                        .map_err(|e| format!("Failed to remove archive: {}", e))?;
+                if config.quiet {
+                    command.arg("-inul");
                 }
-                
-                Ok(())
-            } else {
-                Err("Internal error: command not found for archive type".to_string())
             }
+            _ => {}
+        }
+
+        command.arg(archive);
+
+        if !config.list_only {
+            if let Some(ref dest) = config.destination {
+                command.current_dir(dest);
+            }
+        }
+
+        let output = command
+            .output()
+            .map_err(|e| format!("Failed to execute command: {}", e))?;
+
+        if !output.status.success() {
+            return Err(format!("Extraction failed: {}",
+                String::from_utf8_lossy(&output.stderr)));
         }
+        stdout = String::from_utf8_lossy(&output.stdout).into_owned();
+    }
+
+    // Remove the archive unless the keep flag is set
+    if !config.keep && !config.list_only {
+        fs::remove_file(archive)
+            .map_err(|e| format!("Failed to remove archive: {}", e))?;
+    }
+
+    Ok(stdout)
+}
+
+/// Scheduler: workers pull archive indices from a shared counter and
+/// run extractions concurrently up to the --jobs budget.
+fn run_batch(config: Arc<Config>, tools: Arc<HashMap<&'static str, bool>>) -> usize {
+    let next = Arc::new(AtomicUsize::new(0));
+    let failures = Arc::new(AtomicUsize::new(0));
+    let print_lock = Arc::new(Mutex::new(()));
+
+    let workers = config.jobs.min(config.archives.len()).max(1);
+    let mut handles = Vec::new();
+    for _ in 0..workers {
+        let config = Arc::clone(&config);
+        let tools = Arc::clone(&tools);
+        let next = Arc::clone(&next);
+        let failures = Arc::clone(&failures);
+        let print_lock = Arc::clone(&print_lock);
+        handles.push(thread::spawn(move || {
+            loop {
+                let i = next.fetch_add(1, Ordering::SeqCst);
+                if i >= config.archives.len() {
+                    break;
+                }
+                let archive = &config.archives[i];
+                let result = extract_archive(archive, &config, &tools);
+                let _guard = print_lock.lock().unwrap();
+                match result {
+                    Ok(output) => {
+                        if !config.quiet {
+                            if config.archives.len() > 1 {
+                                println!("==> {}", archive.display());
+                            }
+                            if !output.trim().is_empty() {
+                                println!("{}", output.trim_end());
+                            }
+                        }
+                    }
+                    Err(e) => {
+                        eprintln!("Error: {}: {}", archive.display(), e);
+                        failures.fetch_add(1, Ordering::SeqCst);
+                    }
+                }
+            }
+        }));
+    }
+    for handle in handles {
+        let _ = handle.join();
     }
+    failures.load(Ordering::SeqCst)
 }
 
 fn main() {
     let args: Vec<String> = env::args().collect();
     let mut config = Config {
-        archive_path: PathBuf::new(),
+        archives: Vec::new(),
         destination: None,
+        jobs: thread::available_parallelism().map(|n| n.get()).unwrap_or(4),
         list_only: false,
         force: false,
         quiet: false,
         keep: false,
     };
-    
+
     let mut i = 1;
     while i < args.len() {
         match args[i].as_str() {
@@ -230,38 +383,84 @@ fn main() {
             "-k" | "--keep" => {
                 config.keep = true;
             }
-            _ => {
-                if config.archive_path.as_os_str().is_empty() {
-                    config.archive_path = PathBuf::from(&args[i]);
-                } else {
-                    config.destination = Some(PathBuf::from(&args[i]));
+            "-d" | "--dest" => {
+                i += 1;
+                if i >= args.len() {
+                    eprintln!("Error: --dest requires a directory");
+                    exit(1);
+                }
+                config.destination = Some(PathBuf::from(&args[i]));
+            }
+            "-j" | "--jobs" => {
+                i += 1;
+                let jobs = args.get(i).and_then(|a| a.parse::<usize>().ok());
+                match jobs {
+                    Some(j) if j >= 1 => config.jobs = j,
+                    _ => {
+                        eprintln!("Error: --jobs requires a positive number");
+                        exit(1);
+                    }
                 }
             }
+            _ => {
+                config.archives.push(PathBuf::from(&args[i]));
+            }
         }
         i += 1;
     }
-    
-    if config.archive_path.as_os_str().is_empty() {
+
+    if config.archives.is_empty() {
         eprintln!("Error: No archive specified");
         eprintln!("Try 'extract --help' for more information.");
         exit(1);
     }
-    
-    if !config.archive_path.exists() {
-        eprintln!("Error: Archive file not found: {}", 
-            config.archive_path.display());
-        exit(1);
+
+    // Backward compatibility: a trailing path that is not an existing
+    // file is the destination ('extract archive.zip /path/to/dest').
+    if config.destination.is_none() && config.archives.len() >= 2 {
+        let last = config.archives.last().unwrap();
+        if !last.is_file() {
+            config.destination = config.archives.pop();
+        }
     }
-    
-    match extract_archive(&config) {
-        Ok(_) => {
-            if !config.quiet && !config.list_only {
-                println!("Extraction completed successfully.");
+
+    for archive in config.archives.iter_mut() {
+        // Absolute paths stay valid when the unarchiver runs with its
+        // working directory set to the destination.
+        match fs::canonicalize(&archive) {
+            Ok(abs) => *archive = abs,
+            Err(_) => {
+                eprintln!("Error: Archive file not found: {}", archive.display());
+                exit(1);
             }
         }
-        Err(e) => {
-            eprintln!("Error: {}", e);
-            exit(1);
+    }
+
+    if let Some(ref dest) = config.destination {
+        if !config.list_only {
+            if let Err(e) = fs::create_dir_all(dest) {
+                eprintln!("Error: Failed to create destination directory: {}", e);
+                exit(1);
+            }
         }
     }
-}
\ No newline at end of file
+
+    // Probe every tool this batch needs exactly once.
+    let tools = Arc::new(probe_tools(&config.archives));
+
+    let quiet = config.quiet;
+    let list_only = config.list_only;
+    let total = config.archives.len();
+    let failures = run_batch(Arc::new(config), tools);
+
+    if failures > 0 {
+        exit(1);
+    }
+    if !quiet && !list_only {
+        if total > 1 {
+            println!("Extraction completed successfully ({} archives).", total);
+        } else {
+            println!("Extraction completed successfully.");
+        }
+    }
+}
@@ -1,7 +1,12 @@
+use std::collections::VecDeque;
 use std::env;
 use std::fs;
 use std::io;
-use std::path::{Path, PathBuf};
+use std::io::Write;
+use std::path::PathBuf;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread;
 
 const HELP: &str = r#"
 FTree - File System Tree Visualizer
@@ -78,14 +83,7 @@ fn matches_pattern(name: &str, pattern: &str) -> bool {
     }
 }
 
-fn should_process_file(
-    entry: &fs::DirEntry,
-    config: &Config,
-    is_dir: bool,
-) -> bool {
-    let name = entry.file_name();
-    let name_str = name.to_string_lossy();
-
+fn should_process_file(name_str: &str, config: &Config, is_dir: bool) -> bool {
     // Hidden file check
     if !config.show_hidden && name_str.starts_with('.') {
         return false;
@@ -113,81 +111,269 @@ fn should_process_file(
     true
 }
 
-fn print_tree(
-    path: &Path,
-    prefix: &str,
-    last_item: bool,
+// ---------------------------------------------------------------------------
+// Parallel walker
+//
+// Directory listings are independent tasks, so the traversal fans out
+// across a worker pool that pulls directories from a shared queue —
+// the metadata latency that dominated the single-threaded walk now
+// overlaps. Each listed directory becomes a node in a slab; the main
+// thread is a reorder stage that walks the slab depth-first, printing
+// each subtree in display order as soon as it is ready. Stats are
+// accumulated per worker and merged once at the end.
+// ---------------------------------------------------------------------------
+
+struct Entry {
+    name: String,
+    is_dir: bool,
+    size: u64,
+    child: Option<usize>, // node index, when the subtree is walked
+}
+
+struct Node {
+    ready: bool,
+    entries: Vec<Entry>,
+}
+
+struct Job {
+    node: usize,
+    path: PathBuf,
     depth: usize,
-    config: &Config,
-    stats: &mut TreeStats,
-    is_root: bool,
-) -> io::Result<()> {
-    if let Some(max_depth) = config.max_depth {
-        if depth > max_depth {
-            return Ok(());
+}
+
+struct Walker {
+    queue: Mutex<VecDeque<Job>>,
+    work_cv: Condvar,
+    nodes: Mutex<Vec<Node>>,
+    node_cv: Condvar,
+    pending: AtomicUsize, // outstanding directory jobs
+    stats: Mutex<TreeStats>,
+}
+
+impl Walker {
+    fn new() -> Walker {
+        Walker {
+            queue: Mutex::new(VecDeque::new()),
+            work_cv: Condvar::new(),
+            nodes: Mutex::new(Vec::new()),
+            node_cv: Condvar::new(),
+            pending: AtomicUsize::new(0),
+            stats: Mutex::new(TreeStats::default()),
         }
     }
 
-    let metadata = fs::metadata(path)?;
-    let is_dir = metadata.is_dir();
+    fn push_job(&self, job: Job) {
+        self.pending.fetch_add(1, Ordering::SeqCst);
+        self.queue.lock().unwrap().push_back(job);
+        self.work_cv.notify_one();
+    }
+
+    fn alloc_node(&self) -> usize {
+        let mut nodes = self.nodes.lock().unwrap();
+        nodes.push(Node { ready: false, entries: Vec::new() });
+        nodes.len() - 1
+    }
 
-    if !is_root {
-        let marker = if last_item { "└── " } else { "├── " };
-        print!("{}{}", prefix, marker);
-        
-        let name = path.file_name().unwrap_or_default().to_string_lossy();
-        print!("{}", name);
+    fn finish_node(&self, index: usize, entries: Vec<Entry>) {
+        let mut nodes = self.nodes.lock().unwrap();
+        nodes[index].entries = entries;
+        nodes[index].ready = true;
+        self.node_cv.notify_all();
+    }
 
-        if config.show_size {
-            if is_dir {
-                print!(" [DIR]");
-            } else {
-                print!(" [{}]", format_size(metadata.len()));
+    fn job_done(&self) {
+        if self.pending.fetch_sub(1, Ordering::SeqCst) == 1 {
+            // Last job: wake idle workers so they can exit, and the
+            // printer in case it is waiting on a node.
+            self.work_cv.notify_all();
+            self.node_cv.notify_all();
+        }
+    }
+
+    // Take the entries of a node, blocking until a worker finished it.
+    fn wait_node(&self, index: usize) -> Vec<Entry> {
+        let mut nodes = self.nodes.lock().unwrap();
+        loop {
+            if nodes[index].ready {
+                return std::mem::take(&mut nodes[index].entries);
             }
+            nodes = self.node_cv.wait(nodes).unwrap();
         }
-        println!();
     }
+}
 
-    if is_dir {
-        if !is_root {
-            stats.total_dirs += 1;
+// List one directory: filter, stat and sort its entries, schedule
+// child jobs for subdirectories that still need walking.
+fn process_dir(walker: &Walker, config: &Config, job: Job, local: &mut TreeStats) {
+    // Children of this node sit at depth + 1; stop before listing if
+    // they would fall beyond the display limit.
+    if let Some(max_depth) = config.max_depth {
+        if job.depth + 1 > max_depth {
+            walker.finish_node(job.node, Vec::new());
+            return;
         }
+    }
 
-        let mut entries: Vec<_> = fs::read_dir(path)?
-            .filter_map(|e| e.ok())
-            .filter(|e| should_process_file(e, config, e.path().is_dir()))
-            .collect();
+    let read = match fs::read_dir(&job.path) {
+        Ok(r) => r,
+        Err(_) => {
+            // Unreadable directory: emit it empty rather than
+            // aborting the whole run.
+            walker.finish_node(job.node, Vec::new());
+            return;
+        }
+    };
 
-        entries.sort_by_key(|e| (e.path().is_file(), e.file_name()));
+    let mut entries: Vec<Entry> = Vec::new();
+    for entry in read.filter_map(|e| e.ok()) {
+        let name = entry.file_name().to_string_lossy().into_owned();
+        // Don't follow symlinks: a link into an ancestor would make
+        // the walk cycle forever.
+        let metadata = match fs::symlink_metadata(entry.path()) {
+            Ok(m) => m,
+            Err(_) => continue, // vanished entry
+        };
+        let is_dir = metadata.is_dir();
+        if !should_process_file(&name, config, is_dir) {
+            continue;
+        }
+        if is_dir {
+            local.total_dirs += 1;
+        } else {
+            local.total_files += 1;
+            local.total_size += metadata.len();
+        }
+        entries.push(Entry {
+            name,
+            is_dir,
+            size: metadata.len(),
+            child: None,
+        });
+    }
 
-        let total = entries.len();
-        for (index, entry) in entries.into_iter().enumerate() {
-            let new_prefix = if is_root {
-                String::new()
-            } else if last_item {
+    entries.sort_by(|a, b| (!a.is_dir, &a.name).cmp(&(!b.is_dir, &b.name)));
+
+    let descend = match config.max_depth {
+        Some(max_depth) => job.depth + 2 <= max_depth,
+        None => true,
+    };
+    if descend {
+        for entry in entries.iter_mut() {
+            if entry.is_dir {
+                let node = walker.alloc_node();
+                entry.child = Some(node);
+                walker.push_job(Job {
+                    node,
+                    path: job.path.join(&entry.name),
+                    depth: job.depth + 1,
+                });
+            }
+        }
+    }
+
+    walker.finish_node(job.node, entries);
+}
+
+fn worker(walker: &Walker, config: &Config) {
+    let mut local = TreeStats::default();
+    loop {
+        let job = {
+            let mut queue = walker.queue.lock().unwrap();
+            loop {
+                if let Some(job) = queue.pop_front() {
+                    break job;
+                }
+                if walker.pending.load(Ordering::SeqCst) == 0 {
+                    drop(queue);
+                    let mut stats = walker.stats.lock().unwrap();
+                    stats.total_dirs += local.total_dirs;
+                    stats.total_files += local.total_files;
+                    stats.total_size += local.total_size;
+                    return;
+                }
+                queue = walker.work_cv.wait(queue).unwrap();
+            }
+        };
+        process_dir(walker, config, job, &mut local);
+        walker.job_done();
+    }
+}
+
+// Reorder stage: depth-first over the node slab, blocking on each
+// node until its worker delivers it, so output streams in display
+// order while the walk is still running.
+fn print_node(
+    walker: &Walker,
+    config: &Config,
+    index: usize,
+    prefix: &str,
+    out: &mut impl Write,
+) -> io::Result<()> {
+    let entries = walker.wait_node(index);
+    let total = entries.len();
+    for (i, entry) in entries.into_iter().enumerate() {
+        let last_item = i == total - 1;
+        let marker = if last_item { "└── " } else { "├── " };
+        write!(out, "{}{}{}", prefix, marker, entry.name)?;
+        if config.show_size {
+            if entry.is_dir {
+                write!(out, " [DIR]")?;
+            } else {
+                write!(out, " [{}]", format_size(entry.size))?;
+            }
+        }
+        writeln!(out)?;
+
+        if let Some(child) = entry.child {
+            let new_prefix = if last_item {
                 format!("{}    ", prefix)
             } else {
                 format!("{}│   ", prefix)
             };
-
-            print_tree(
-                &entry.path(),
-                &new_prefix,
-                index == total - 1,
-                depth + 1,
-                config,
-                stats,
-                false,
-            )?;
+            print_node(walker, config, child, &new_prefix, out)?;
         }
-    } else {
-        stats.total_files += 1;
-        stats.total_size += metadata.len();
     }
-
     Ok(())
 }
 
+fn print_tree(config: Arc<Config>) -> io::Result<TreeStats> {
+    let walker = Arc::new(Walker::new());
+
+    let root_node = walker.alloc_node();
+    walker.push_job(Job {
+        node: root_node,
+        path: config.root.clone(),
+        depth: 0,
+    });
+
+    let threads = thread::available_parallelism()
+        .map(|n| n.get())
+        .unwrap_or(4)
+        .min(16);
+    let mut handles = Vec::new();
+    for _ in 0..threads {
+        let walker = Arc::clone(&walker);
+        let config = Arc::clone(&config);
+        handles.push(thread::spawn(move || worker(&walker, &config)));
+    }
+
+    let stdout = io::stdout();
+    let mut out = io::BufWriter::new(stdout.lock());
+    print_node(&walker, &config, root_node, "", &mut out)?;
+    out.flush()?;
+
+    for handle in handles {
+        let _ = handle.join();
+    }
+
+    let stats = walker.stats.lock().unwrap();
+    Ok(TreeStats {
+        total_dirs: stats.total_dirs,
+        total_files: stats.total_files,
+        total_size: stats.total_size,
+    })
+}
+
 fn main() -> io::Result<()> {
     let args: Vec<String> = env::args().collect();
     let mut config = Config {
@@ -250,17 +436,9 @@ fn main() -> io::Result<()> {
         ));
     }
 
-    let mut stats = TreeStats::default();
     println!("{}", config.root.display());
-    print_tree(
-        &config.root,
-        "",
-        true,
-        0,
-        &config,
-        &mut stats,
-        true,
-    )?;
+    let config = Arc::new(config);
+    let stats = print_tree(Arc::clone(&config))?;
 
     println!("\nSummary:");
     println!("  {} directories", stats.total_dirs);
@@ -1,6 +1,17 @@
 use std::env;
-use std::process::{Command, exit};
-use std::collections::HashMap;
+use std::fs;
+use std::process::exit;
+use std::collections::{HashMap, HashSet};
+
+// Direct syscalls instead of shelling out to kill/id; plain rustc
+// links libc anyway.
+extern "C" {
+    fn kill(pid: i32, sig: i32) -> i32;
+    fn geteuid() -> u32;
+}
+
+const SIGTERM: i32 = 15;
+const SIGKILL: i32 = 9;
 
 const HELP: &str = r#"
 KillPort - Kill processes using specified ports
@@ -41,62 +52,183 @@ struct ProcessInfo {
     state: String,
 }
 
-fn get_processes_by_port(port: u16) -> Vec<ProcessInfo> {
-    let mut processes = Vec::new();
-    
-    // Query TCP/UDP connections
-    if let Ok(output) = Command::new("ss")
-        .args(&["-tupln"])
-        .output() {
-        
-        let output = String::from_utf8_lossy(&output.stdout);
-        
-        for line in output.lines().skip(1) { // Skip the header line
-            let fields: Vec<&str> = line.split_whitespace().collect();
-            if fields.len() >= 6 {
-                // Check whether this line contains our port
-                if fields[3].contains(&format!(":{}", port)) {
-                    // Extract PID from the last field
-                    if let Some(pid_str) = fields.last()
-                        .and_then(|s| s.split(',').find(|s| s.starts_with("pid=")))
-                        .and_then(|s| s.split('=').nth(1)) {
-                        
-                        if let Ok(pid) = pid_str.parse::<u32>() {
-                            // Get process details
-                            if let Ok(proc_output) = Command::new("ps")
-                                .args(&["-p", &pid.to_string(), "-o", "comm=,user="])
-                                .output() {
-                                
-                                let proc_info = String::from_utf8_lossy(&proc_output.stdout);
-                                let proc_fields: Vec<&str> = proc_info.split_whitespace().collect();
-                                
-                                if proc_fields.len() >= 2 {
-                                    processes.push(ProcessInfo {
-                                        pid,
-                                        name: proc_fields[0].to_string(),
-                                        user: proc_fields[1].to_string(),
-                                        protocol: fields[0].to_string(),
-                                        state: fields[1].to_string(),
-                                    });
-                                }
-                            }
-                        }
-                    }
-                }
+struct SocketEntry {
+    port: u16,
+    protocol: &'static str,
+    state: String,
+}
+
+fn tcp_state_name(code: u8) -> &'static str {
+    match code {
+        0x01 => "ESTAB",
+        0x02 => "SYN-SENT",
+        0x03 => "SYN-RECV",
+        0x04 => "FIN-WAIT-1",
+        0x05 => "FIN-WAIT-2",
+        0x06 => "TIME-WAIT",
+        0x07 => "CLOSE",
+        0x08 => "CLOSE-WAIT",
+        0x09 => "LAST-ACK",
+        0x0a => "LISTEN",
+        0x0b => "CLOSING",
+        _ => "UNKNOWN",
+    }
+}
+
+// Parse one /proc/net table, keeping sockets whose local port is in
+// the requested set, keyed by inode. Columns: local_address is field
+// 1 ("HEXIP:HEXPORT"), state field 3, inode field 9.
+fn scan_net_table(path: &str, protocol: &'static str, is_tcp: bool,
+                  ports: &HashSet<u16>, inodes: &mut HashMap<u64, SocketEntry>) {
+    let content = match fs::read_to_string(path) {
+        Ok(c) => c,
+        Err(_) => return, // table absent (e.g. no IPv6)
+    };
+
+    for line in content.lines().skip(1) {
+        let fields: Vec<&str> = line.split_whitespace().collect();
+        if fields.len() < 10 {
+            continue;
+        }
+        let port = match fields[1].rsplit(':').next()
+            .and_then(|p| u16::from_str_radix(p, 16).ok()) {
+            Some(p) => p,
+            None => continue,
+        };
+        if !ports.contains(&port) {
+            continue;
+        }
+        let inode = match fields[9].parse::<u64>() {
+            Ok(i) if i != 0 => i,
+            _ => continue,
+        };
+        let state = if is_tcp {
+            u8::from_str_radix(fields[3], 16)
+                .map(tcp_state_name)
+                .unwrap_or("UNKNOWN")
+                .to_string()
+        } else {
+            "UNCONN".to_string()
+        };
+        inodes.insert(inode, SocketEntry { port, protocol, state });
+    }
+}
+
+// Username lookup from /etc/passwd, parsed once.
+fn load_users() -> HashMap<u32, String> {
+    let mut users = HashMap::new();
+    if let Ok(content) = fs::read_to_string("/etc/passwd") {
+        for line in content.lines() {
+            let mut parts = line.split(':');
+            let name = parts.next();
+            parts.next(); // password field
+            let uid = parts.next().and_then(|u| u.parse::<u32>().ok());
+            if let (Some(name), Some(uid)) = (name, uid) {
+                users.entry(uid).or_insert_with(|| name.to_string());
             }
         }
     }
-    
-    processes
+    users
+}
+
+// Name and real uid from /proc/PID/status, read in one pass.
+fn read_process_status(pid: u32) -> Option<(String, u32)> {
+    let content = fs::read_to_string(format!("/proc/{}/status", pid)).ok()?;
+    let mut name = None;
+    let mut uid = None;
+    for line in content.lines() {
+        if let Some(rest) = line.strip_prefix("Name:") {
+            name = Some(rest.trim().to_string());
+        } else if let Some(rest) = line.strip_prefix("Uid:") {
+            uid = rest.split_whitespace().next().and_then(|u| u.parse().ok());
+        }
+        if name.is_some() && uid.is_some() {
+            break;
+        }
+    }
+    Some((name?, uid?))
+}
+
+// Single-pass scanner: build an inode->port map from the /proc/net
+// tables once, then one walk over /proc/*/fd resolving socket links,
+// reading each owner's name and uid in the same pass. No subprocesses.
+fn get_processes_by_ports(ports: &[u16]) -> HashMap<u16, Vec<ProcessInfo>> {
+    let port_set: HashSet<u16> = ports.iter().cloned().collect();
+    let mut inodes = HashMap::new();
+    scan_net_table("/proc/net/tcp", "tcp", true, &port_set, &mut inodes);
+    scan_net_table("/proc/net/tcp6", "tcp6", true, &port_set, &mut inodes);
+    scan_net_table("/proc/net/udp", "udp", false, &port_set, &mut inodes);
+    scan_net_table("/proc/net/udp6", "udp6", false, &port_set, &mut inodes);
+
+    let mut result: HashMap<u16, Vec<ProcessInfo>> = HashMap::new();
+    if inodes.is_empty() {
+        return result;
+    }
+
+    let users = load_users();
+    let mut seen: HashSet<(u16, u32)> = HashSet::new();
+
+    let proc_entries = match fs::read_dir("/proc") {
+        Ok(e) => e,
+        Err(_) => return result,
+    };
+    for entry in proc_entries.flatten() {
+        let pid: u32 = match entry.file_name().to_str().and_then(|n| n.parse().ok()) {
+            Some(p) => p,
+            None => continue, // not a process directory
+        };
+        let fd_dir = match fs::read_dir(format!("/proc/{}/fd", pid)) {
+            Ok(d) => d,
+            Err(_) => continue, // permission denied or process exited
+        };
+
+        let mut status: Option<(String, u32)> = None;
+        for fd in fd_dir.flatten() {
+            let target = match fs::read_link(fd.path()) {
+                Ok(t) => t,
+                Err(_) => continue,
+            };
+            let target = match target.to_str() {
+                Some(t) => t,
+                None => continue,
+            };
+            let inode: u64 = match target.strip_prefix("socket:[")
+                .and_then(|t| t.strip_suffix(']'))
+                .and_then(|t| t.parse().ok()) {
+                Some(i) => i,
+                None => continue,
+            };
+            let entry = match inodes.get(&inode) {
+                Some(e) => e,
+                None => continue,
+            };
+            if !seen.insert((entry.port, pid)) {
+                continue; // several fds on the same socket
+            }
+            if status.is_none() {
+                status = read_process_status(pid);
+            }
+            if let Some((ref name, uid)) = status {
+                let user = users.get(&uid)
+                    .cloned()
+                    .unwrap_or_else(|| uid.to_string());
+                result.entry(entry.port).or_insert_with(Vec::new).push(ProcessInfo {
+                    pid,
+                    name: name.clone(),
+                    user,
+                    protocol: entry.protocol.to_string(),
+                    state: entry.state.clone(),
+                });
+            }
+        }
+    }
+
+    result
 }
 
 fn kill_process(pid: u32, force: bool) -> bool {
-    let signal = if force { "SIGKILL" } else { "SIGTERM" };
-    Command::new("kill")
-        .args(&[if force { "-9" } else { "-15" }, &pid.to_string()])
-        .status()
-        .map(|status| status.success())
-        .unwrap_or(false)
+    let sig = if force { SIGKILL } else { SIGTERM };
+    unsafe { kill(pid as i32, sig) == 0 }
 }
 
 fn print_process_info(proc: &ProcessInfo, port: u16, verbose: bool) {
@@ -161,31 +293,18 @@ fn main() {
     }
     
     // Check root privileges for ports below 1024
-    let is_root = Command::new("id")
-        .arg("-u")
-        .output()
-        .map(|output| String::from_utf8_lossy(&output.stdout).trim() == "0")
-        .unwrap_or(false);
-    
+    let is_root = unsafe { geteuid() } == 0;
+
     let needs_root = config.ports.iter().any(|&p| p < 1024);
     if needs_root && !is_root && !config.list_only {
         eprintln!("Error: Root privileges required for ports below 1024");
         exit(1);
     }
-    
-    let mut port_processes = HashMap::new();
-    let mut found = false;
-    
-    // Collect process information for each port
-    for &port in &config.ports {
-        let processes = get_processes_by_port(port);
-        if !processes.is_empty() {
-            found = true;
-            port_processes.insert(port, processes);
-        }
-    }
-    
-    if !found {
+
+    // One scan covers all requested ports
+    let port_processes = get_processes_by_ports(&config.ports);
+
+    if port_processes.is_empty() {
         if !config.quiet {
             println!("No processes found for specified ports");
         }
@@ -6,21 +6,30 @@
 #include <stdexcept>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <condition_variable>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
 #include <fstream>
+#include <unordered_map>
 
 // Network headers
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/ip.h>
 #include <netinet/ip_icmp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/epoll.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <ifaddrs.h>
 #include <net/if.h>
+
+#include "advbox_core.hpp"
 #include <unistd.h>
 
 const char* HELP = R"(
@@ -36,12 +45,16 @@ Options:
     -p, --parallel N     Number of parallel threads (default: 4)
     -n, --no-resolve    Don't resolve hostnames
     -v, --verbose       Show more detailed information
+    --cidr A.B.C.D/N    Scan the given range instead of the interface /24
+    --pps N             Limit probe rate to N packets per second
+    --profile           Report stage timings on stderr after the scan
 
 Examples:
     lanlist
     lanlist -i eth0
     lanlist -t 5 -p 8
     lanlist --no-resolve
+    lanlist --cidr 10.20.0.0/22 --pps 500
 )";
 
 struct NetworkDevice {
@@ -59,9 +72,58 @@ private:
     int threads;
     bool resolve_names;
     bool verbose;
+    std::string cidr;
+    int pps = 0;
     std::mutex print_mutex;
     std::vector<NetworkDevice> devices;
 
+    // --profile instrumentation. The probe engine is single-threaded, so
+    // it fills probe_prof directly; each resolver thread owns one slot of
+    // a per-thread vector that is only read after the pool joins, so the
+    // hot paths take no locks for bookkeeping.
+    struct ProbeProfile {
+        uint64_t send_ns = 0;    // sendto loop, including rate limiting
+        uint64_t recv_ns = 0;    // epoll_wait and reply drain
+        uint64_t sent = 0;
+        uint64_t received = 0;
+    };
+    struct ResolverProfile {
+        uint64_t dns_ns = 0;     // waiting on resolve_hostname
+        uint64_t lookups = 0;
+    };
+    bool profiling = false;
+    ProbeProfile probe_prof;
+
+    static uint64_t prof_now() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void print_profile(uint64_t arp_ns,
+                       const std::vector<ResolverProfile>& resolver_profs) const {
+        fprintf(stderr, "\nProfile:\n");
+        fprintf(stderr, "  probe send   %8.1f ms  (%llu probes)\n",
+                static_cast<double>(probe_prof.send_ns) / 1e6,
+                static_cast<unsigned long long>(probe_prof.sent));
+        fprintf(stderr, "  probe recv   %8.1f ms  (%llu replies)\n",
+                static_cast<double>(probe_prof.recv_ns) / 1e6,
+                static_cast<unsigned long long>(probe_prof.received));
+        fprintf(stderr, "  arp parse    %8.1f ms\n",
+                static_cast<double>(arp_ns) / 1e6);
+        for (size_t i = 0; i < resolver_profs.size(); ++i) {
+            const ResolverProfile& p = resolver_profs[i];
+            fprintf(stderr, "  dns wait %2zu  %8.1f ms  (%llu lookups, %.1f ms avg)\n",
+                    i,
+                    static_cast<double>(p.dns_ns) / 1e6,
+                    static_cast<unsigned long long>(p.lookups),
+                    p.lookups > 0
+                        ? static_cast<double>(p.dns_ns) / 1e6 /
+                              static_cast<double>(p.lookups)
+                        : 0.0);
+        }
+    }
+
     std::string get_default_interface() {
         struct ifaddrs *ifaddr, *ifa;
         std::string result;
@@ -120,10 +182,13 @@ private:
         return result;
     }
 
-    std::string get_mac_address(const std::string& ip) {
+    // Parsed once per scan instead of re-reading /proc/net/arp for every
+    // responding host.
+    std::unordered_map<std::string, std::string> load_arp_table() {
+        std::unordered_map<std::string, std::string> table;
         std::ifstream arp_file("/proc/net/arp");
         if (!arp_file.is_open()) {
-            return "unknown";
+            return table;
         }
 
         std::string line;
@@ -132,119 +197,261 @@ private:
         while (std::getline(arp_file, line)) {
             std::istringstream iss(line);
             std::string ip_addr, hw_type, flags, hw_addr;
-            
+
             iss >> ip_addr >> hw_type >> flags >> hw_addr;
-            
-            if (ip_addr == ip && hw_addr != "00:00:00:00:00:00") {
-                return hw_addr;
+
+            if (!hw_addr.empty() && hw_addr != "00:00:00:00:00:00") {
+                table.emplace(ip_addr, hw_addr);
             }
         }
 
-        return "unknown";
+        return table;
     }
 
+    // Reverse lookup with a hard per-query deadline: getnameinfo has no
+    // timeout of its own, so it runs on a detached helper thread writing
+    // into shared state, and the caller stops waiting after `timeout`
+    // seconds. An abandoned lookup finishes (or fails) in the background
+    // without anyone blocking on it.
     std::string resolve_hostname(const std::string& ip) {
         if (!resolve_names) return "";
 
-        char hostname[NI_MAXHOST];
-        struct sockaddr_in sa;
-        sa.sin_family = AF_INET;
-        sa.sin_port = 0;
-        inet_pton(AF_INET, ip.c_str(), &sa.sin_addr);
+        struct Query {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool done = false;
+            std::string result;
+        };
+        auto query = std::make_shared<Query>();
+
+        std::thread([query, ip] {
+            char hostname[NI_MAXHOST];
+            struct sockaddr_in sa{};
+            sa.sin_family = AF_INET;
+            inet_pton(AF_INET, ip.c_str(), &sa.sin_addr);
+
+            std::string result;
+            if (getnameinfo((struct sockaddr*)&sa, sizeof(sa),
+                           hostname, sizeof(hostname),
+                           nullptr, 0, NI_NAMEREQD) == 0) {
+                result = hostname;
+            }
 
-        if (getnameinfo((struct sockaddr*)&sa, sizeof(sa), 
-                       hostname, sizeof(hostname), 
-                       nullptr, 0, NI_NAMEREQD) == 0) {
-            return hostname;
-        }
+            std::lock_guard<std::mutex> lock(query->mutex);
+            query->result = std::move(result);
+            query->done = true;
+            query->cv.notify_one();
+        }).detach();
 
-        return "";
+        std::unique_lock<std::mutex> lock(query->mutex);
+        query->cv.wait_for(lock, std::chrono::seconds(timeout),
+                           [&] { return query->done; });
+        return query->result;
     }
 
-    bool ping(const std::string& ip, int& response_time) {
-        int sock = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
-        if (sock < 0) {
-            if (errno == EPERM) {
-                throw std::runtime_error("Root privileges required");
-            }
-            return false;
+    static uint16_t icmp_checksum(const void* data, size_t len) {
+        const uint16_t* words = static_cast<const uint16_t*>(data);
+        uint32_t sum = 0;
+        while (len > 1) {
+            sum += *words++;
+            len -= 2;
         }
+        if (len == 1) {
+            sum += *reinterpret_cast<const uint8_t*>(words);
+        }
+        sum = (sum >> 16) + (sum & 0xFFFF);
+        sum += sum >> 16;
+        return static_cast<uint16_t>(~sum);
+    }
 
-        struct timeval tv;
-        tv.tv_sec = timeout;
-        tv.tv_usec = 0;
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    static void parse_cidr(const std::string& spec,
+                           uint32_t& network, int& prefix) {
+        size_t slash = spec.find('/');
+        if (slash == std::string::npos) {
+            throw std::runtime_error("CIDR must be of the form A.B.C.D/N");
+        }
 
-        struct sockaddr_in addr;
-        addr.sin_family = AF_INET;
-        addr.sin_port = 0;
-        inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+        struct in_addr in;
+        if (inet_pton(AF_INET, spec.substr(0, slash).c_str(), &in) != 1) {
+            throw std::runtime_error("Invalid address in CIDR: " + spec);
+        }
 
-        struct icmp icmp_hdr;
-        icmp_hdr.icmp_type = ICMP_ECHO;
-        icmp_hdr.icmp_code = 0;
-        icmp_hdr.icmp_cksum = 0;
-        icmp_hdr.icmp_seq = 1;
-        icmp_hdr.icmp_id = getpid();
-        icmp_hdr.icmp_cksum = 0;
+        prefix = static_cast<int>(advbox::to_i64(spec.substr(slash + 1), "prefix length"));
+        if (prefix < 8 || prefix > 32) {
+            throw std::runtime_error("CIDR prefix must be between 8 and 32");
+        }
 
-        auto start = std::chrono::high_resolution_clock::now();
+        uint32_t mask = prefix == 32 ? 0xFFFFFFFFu
+                                     : ~((1u << (32 - prefix)) - 1);
+        network = ntohl(in.s_addr) & mask;
+    }
 
-        if (sendto(sock, &icmp_hdr, sizeof(icmp_hdr), 0,
-                  (struct sockaddr*)&addr, sizeof(addr)) <= 0) {
-            close(sock);
-            return false;
-        }
+    static std::string addr_to_string(uint32_t addr) {
+        char buf[INET_ADDRSTRLEN];
+        struct in_addr in;
+        in.s_addr = htonl(addr);
+        inet_ntop(AF_INET, &in, buf, sizeof(buf));
+        return buf;
+    }
 
-        char buffer[IP_MAXPACKET];
-        struct sockaddr_in from;
-        socklen_t fromlen = sizeof(from);
+    struct ProbeResult {
+        uint32_t addr;       // host byte order
+        int response_time;   // milliseconds
+    };
+
+    // Async probe engine: one raw ICMP socket, echo requests for the whole
+    // range fired back-to-back, replies collected via epoll until every
+    // outstanding probe has answered or aged past the timeout. Replies are
+    // matched by source address (the sequence number is only 16 bits) and
+    // filtered on our echo identifier. A full /24 completes in roughly one
+    // timeout interval instead of one interval per silent host.
+    std::vector<ProbeResult> async_probe(const std::vector<uint32_t>& targets) {
+        using clock = std::chrono::steady_clock;
+        std::vector<ProbeResult> results;
 
-        if (recvfrom(sock, buffer, sizeof(buffer), 0,
-                    (struct sockaddr*)&from, &fromlen) <= 0) {
-            close(sock);
-            return false;
+        int sock = socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+        if (sock < 0) {
+            if (errno == EPERM) {
+                throw std::runtime_error("Root privileges required");
+            }
+            return results;
         }
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
 
-        auto end = std::chrono::high_resolution_clock::now();
-        response_time = std::chrono::duration_cast<std::chrono::milliseconds>
-                       (end - start).count();
-
-        close(sock);
-        return true;
-    }
+        int epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd < 0) {
+            close(sock);
+            return results;
+        }
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = sock;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev);
+
+        std::unordered_map<uint32_t, clock::time_point> outstanding;
+        outstanding.reserve(targets.size());
+        uint16_t ident = static_cast<uint16_t>(getpid() & 0xFFFF);
+
+        size_t next = 0;
+        uint16_t seq = 0;
+        clock::time_point deadline = clock::now() + std::chrono::seconds(timeout);
+
+        // Token bucket for --pps: refilled continuously, with a tenth of
+        // a second of burst headroom so pacing stays smooth without
+        // hammering the access switches
+        double bucket_cap = pps > 0 ? std::max(1.0, pps / 10.0) : 0.0;
+        double tokens = bucket_cap;
+        clock::time_point last_refill = clock::now();
+
+        while (true) {
+            // Fire as many requests as the socket (and rate limit) will take
+            uint64_t send_start = profiling ? prof_now() : 0;
+            while (next < targets.size()) {
+                if (pps > 0) {
+                    auto now = clock::now();
+                    tokens = std::min(bucket_cap, tokens +
+                        pps * std::chrono::duration<double>(now - last_refill).count());
+                    last_refill = now;
+                    if (tokens < 1.0) {
+                        break;
+                    }
+                }
+                struct sockaddr_in addr{};
+                addr.sin_family = AF_INET;
+                addr.sin_addr.s_addr = htonl(targets[next]);
+
+                struct icmp hdr{};
+                hdr.icmp_type = ICMP_ECHO;
+                hdr.icmp_code = 0;
+                hdr.icmp_id = htons(ident);
+                hdr.icmp_seq = htons(seq++);
+                hdr.icmp_cksum = icmp_checksum(&hdr, ICMP_MINLEN);
+
+                if (sendto(sock, &hdr, ICMP_MINLEN, 0,
+                           (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+                    if (errno == EAGAIN || errno == ENOBUFS) {
+                        // Socket buffer full; drain replies and retry
+                        break;
+                    }
+                    ++next;
+                    continue;
+                }
+                outstanding.emplace(targets[next], clock::now());
+                ++next;
+                probe_prof.sent++;
+                deadline = clock::now() + std::chrono::seconds(timeout);
+                if (pps > 0) {
+                    tokens -= 1.0;
+                }
+            }
+            if (profiling) {
+                probe_prof.send_ns += prof_now() - send_start;
+            }
 
-    void scan_range(const std::string& base_ip, int start, int end) {
-        std::string ip_prefix = base_ip.substr(0, base_ip.find_last_of('.') + 1);
+            auto now = clock::now();
+            if (next >= targets.size() &&
+                (outstanding.empty() || now >= deadline)) {
+                break;
+            }
 
-        for (int i = start; i <= end; i++) {
-            std::string ip = ip_prefix + std::to_string(i);
-            int response_time = 0;
+            // While sends are still pending, poll briefly so the send loop
+            // gets another chance; otherwise sleep until the deadline
+            int wait_ms = 10;
+            if (next >= targets.size()) {
+                wait_ms = static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - now).count()) + 1;
+            }
 
-            if (ping(ip, response_time)) {
-                NetworkDevice device;
-                device.ip = ip;
-                device.mac = get_mac_address(ip);
-                device.hostname = resolve_hostname(ip);
-                device.is_up = true;
-                device.response_time = response_time;
+            uint64_t recv_start = profiling ? prof_now() : 0;
+            struct epoll_event events[1];
+            int n = epoll_wait(epfd, events, 1, wait_ms);
+            if (n <= 0) {
+                if (profiling) {
+                    probe_prof.recv_ns += prof_now() - recv_start;
+                }
+                continue;
+            }
 
-                {
-                    std::lock_guard<std::mutex> lock(print_mutex);
-                    devices.push_back(device);
+            // Drain every reply currently queued on the socket
+            char buffer[IP_MAXPACKET];
+            struct sockaddr_in from;
+            socklen_t fromlen = sizeof(from);
+            ssize_t len;
+            while ((len = recvfrom(sock, buffer, sizeof(buffer), 0,
+                                   (struct sockaddr*)&from, &fromlen)) > 0) {
+                const struct ip* ip_hdr = reinterpret_cast<struct ip*>(buffer);
+                size_t hlen = ip_hdr->ip_hl * 4;
+                if (static_cast<size_t>(len) < hlen + ICMP_MINLEN) {
+                    continue;
+                }
+                const struct icmp* reply =
+                    reinterpret_cast<struct icmp*>(buffer + hlen);
+                if (reply->icmp_type != ICMP_ECHOREPLY ||
+                    ntohs(reply->icmp_id) != ident) {
+                    continue;
+                }
 
-                    if (verbose) {
-                        std::cout << "Found device: " << ip 
-                                 << " (" << device.mac << ")"
-                                 << " response time: " << response_time << "ms";
-                        if (!device.hostname.empty()) {
-                            std::cout << " hostname: " << device.hostname;
-                        }
-                        std::cout << std::endl;
-                    }
+                uint32_t src = ntohl(from.sin_addr.s_addr);
+                auto it = outstanding.find(src);
+                if (it == outstanding.end()) {
+                    continue;
                 }
+                int rtt = static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        clock::now() - it->second).count());
+                results.push_back(ProbeResult{src, rtt});
+                outstanding.erase(it);
+                probe_prof.received++;
+            }
+            if (profiling) {
+                probe_prof.recv_ns += prof_now() - recv_start;
             }
         }
+
+        close(epfd);
+        close(sock);
+        return results;
     }
 
 public:
@@ -282,65 +489,166 @@ public:
         verbose = v;
     }
 
+    void set_cidr(const std::string& spec) {
+        uint32_t network;
+        int prefix;
+        parse_cidr(spec, network, prefix); // Validate early
+        cidr = spec;
+    }
+
+    void set_pps(int n) {
+        if (n < 1) {
+            throw std::runtime_error("Rate limit must be at least 1 pps");
+        }
+        pps = n;
+    }
+
+    void set_profiling(bool value) {
+        profiling = value;
+    }
+
     void scan() {
         devices.clear();
-        std::string base_ip = get_interface_ip();
-        std::cout << "Scanning network on interface " << interface 
-                  << " (" << base_ip << ")..." << std::endl;
-
-        std::vector<std::thread> thread_pool;
-        int ips_per_thread = 256 / threads;
-        
-        for (int i = 0; i < threads; i++) {
-            int start = i * ips_per_thread;
-            int end = (i == threads - 1) ? 255 : start + ips_per_thread - 1;
-            thread_pool.emplace_back(&NetworkScanner::scan_range, 
-                                   this, base_ip, start, end);
+
+        uint32_t network;
+        int prefix;
+        if (!cidr.empty()) {
+            parse_cidr(cidr, network, prefix);
+            std::cout << "Scanning " << cidr << "..." << std::endl;
+        } else {
+            std::string base_ip = get_interface_ip();
+            std::cout << "Scanning network on interface " << interface
+                      << " (" << base_ip << ")..." << std::endl;
+
+            struct in_addr in;
+            if (inet_pton(AF_INET, base_ip.c_str(), &in) != 1) {
+                throw std::runtime_error("Invalid interface address: " + base_ip);
+            }
+            network = ntohl(in.s_addr) & 0xFFFFFF00u;
+            prefix = 24;
         }
 
-        for (auto& thread : thread_pool) {
-            thread.join();
+        // Host addresses in the prefix; network and broadcast are skipped
+        // for anything wider than a /31
+        uint32_t span = prefix == 32 ? 1 : (1u << (32 - prefix));
+        uint32_t first = prefix >= 31 ? network : network + 1;
+        uint32_t count = prefix >= 31 ? span : span - 2;
+
+        std::vector<uint32_t> targets;
+        targets.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            targets.push_back(first + i);
         }
 
-        // Sort devices by IP address
-        std::sort(devices.begin(), devices.end(),
-                 [](const NetworkDevice& a, const NetworkDevice& b) {
-                     return a.ip < b.ip;
+        std::vector<ProbeResult> probes = async_probe(targets);
+        std::sort(probes.begin(), probes.end(),
+                 [](const ProbeResult& a, const ProbeResult& b) {
+                     return a.addr < b.addr;
                  });
 
-        // Print results
-        std::cout << "\nFound " << devices.size() << " active devices:\n\n";
-
-        if (!devices.empty()) {
-            // Determine the maximum field widths
-            size_t max_ip = 15;  // xxx.xxx.xxx.xxx
-            size_t max_mac = 17; // xx:xx:xx:xx:xx:xx
-            size_t max_hostname = 0;
-            
-            for (const auto& device : devices) {
-                if (device.hostname.length() > max_hostname) {
-                    max_hostname = device.hostname.length();
-                }
+        // Snapshot the ARP table once, now that the probes have populated it
+        uint64_t arp_start = profiling ? prof_now() : 0;
+        std::unordered_map<std::string, std::string> arp_table = load_arp_table();
+        uint64_t arp_ns = profiling ? prof_now() - arp_start : 0;
+
+        std::cout << "\nFound " << probes.size() << " active devices:\n\n";
+
+        if (probes.empty()) {
+            if (profiling) {
+                print_profile(arp_ns, {});
             }
+            return;
+        }
 
-            // Print table header
-            std::cout << std::left 
-                     << std::setw(max_ip + 2) << "IP Address"
-                     << std::setw(max_mac + 2) << "MAC Address"
-                     << std::setw(12) << "Response"
-                     << (resolve_names ? "Hostname" : "") << std::endl;
-            
-            std::cout << std::string(max_ip + max_mac + 14 + 
-                      (resolve_names ? max_hostname : 0), '-') << std::endl;
-
-            // Print device rows
-            for (const auto& device : devices) {
-                std::cout << std::left 
-                         << std::setw(max_ip + 2) << device.ip
-                         << std::setw(max_mac + 2) << device.mac
-                         << std::setw(8) << device.response_time << "ms  "
-                         << (resolve_names ? device.hostname : "") << std::endl;
+        size_t max_ip = 15;  // xxx.xxx.xxx.xxx
+        size_t max_mac = 17; // xx:xx:xx:xx:xx:xx
+
+        // Table output goes through one buffered writer; rows are
+        // appended under print_mutex and flushed as they resolve so
+        // the stream stays live.
+        advbox::BufWriter table(stdout, 16 * 1024);
+
+        // Print table header
+        table.pad_right("IP Address", max_ip + 2);
+        table.pad_right("MAC Address", max_mac + 2);
+        table.pad_right("Response", 12);
+        if (resolve_names) {
+            table.write("Hostname");
+        }
+        table.put('\n');
+        table.write(std::string(max_ip + max_mac + 14 +
+                    (resolve_names ? 8 : 0), '-'));
+        table.put('\n');
+        table.flush();
+
+        // Resolve hostnames in parallel and stream each row the moment
+        // its lookup finishes, so nothing waits for the slowest PTR reply
+        devices.assign(probes.size(), NetworkDevice{});
+        std::atomic<size_t> next_probe{0};
+
+        auto resolver = [&](ResolverProfile& prof) {
+            size_t i;
+            while ((i = next_probe.fetch_add(1)) < probes.size()) {
+                NetworkDevice device;
+                device.ip = addr_to_string(probes[i].addr);
+                auto it = arp_table.find(device.ip);
+                device.mac = (it != arp_table.end()) ? it->second : "unknown";
+                uint64_t dns_start = profiling ? prof_now() : 0;
+                device.hostname = resolve_hostname(device.ip);
+                if (profiling) {
+                    prof.dns_ns += prof_now() - dns_start;
+                    prof.lookups++;
+                }
+                device.is_up = true;
+                device.response_time = probes[i].response_time;
+
+                {
+                    std::lock_guard<std::mutex> lock(print_mutex);
+                    if (verbose) {
+                        table.write("Found device: ");
+                        table.write(device.ip);
+                        table.write(" (");
+                        table.write(device.mac);
+                        table.write(") response time: ");
+                        char ms[24];
+                        size_t ms_len = advbox::format_i64(ms, device.response_time);
+                        table.write(std::string_view(ms, ms_len));
+                        table.write("ms");
+                        if (!device.hostname.empty()) {
+                            table.write(" hostname: ");
+                            table.write(device.hostname);
+                        }
+                        table.put('\n');
+                    }
+                    table.pad_right(device.ip, max_ip + 2);
+                    table.pad_right(device.mac, max_mac + 2);
+                    char ms[24];
+                    size_t ms_len = advbox::format_i64(ms, device.response_time);
+                    table.pad_right(std::string_view(ms, ms_len), 8);
+                    table.write("ms  ");
+                    if (resolve_names) {
+                        table.write(device.hostname);
+                    }
+                    table.put('\n');
+                    table.flush();
+                }
+
+                devices[i] = std::move(device);
             }
+        };
+
+        size_t pool_size = std::min<size_t>(threads, probes.size());
+        std::vector<ResolverProfile> resolver_profs(pool_size);
+        std::vector<std::thread> resolvers;
+        for (size_t i = 0; i < pool_size; i++) {
+            resolvers.emplace_back(resolver, std::ref(resolver_profs[i]));
+        }
+        for (auto& thread : resolvers) {
+            thread.join();
+        }
+
+        if (profiling) {
+            print_profile(arp_ns, resolver_profs);
         }
     }
 };
@@ -365,13 +673,13 @@ int main(int argc, char* argv[]) {
                 if (++i >= args.size()) {
                     throw std::runtime_error("Timeout value required");
                 }
-                scanner.set_timeout(std::stoi(args[i]));
+                scanner.set_timeout(static_cast<int>(advbox::to_i64(args[i], "timeout")));
             }
             else if (args[i] == "-p" || args[i] == "--parallel") {
                 if (++i >= args.size()) {
                     throw std::runtime_error("Thread count required");
                 }
-                scanner.set_threads(std::stoi(args[i]));
+                scanner.set_threads(static_cast<int>(advbox::to_i64(args[i], "thread count")));
             }
             else if (args[i] == "-n" || args[i] == "--no-resolve") {
                 scanner.set_resolve_names(false);
@@ -379,6 +687,21 @@ int main(int argc, char* argv[]) {
             else if (args[i] == "-v" || args[i] == "--verbose") {
                 scanner.set_verbose(true);
             }
+            else if (args[i] == "--cidr") {
+                if (++i >= args.size()) {
+                    throw std::runtime_error("CIDR range required");
+                }
+                scanner.set_cidr(args[i]);
+            }
+            else if (args[i] == "--pps") {
+                if (++i >= args.size()) {
+                    throw std::runtime_error("Rate limit value required");
+                }
+                scanner.set_pps(static_cast<int>(advbox::to_i64(args[i], "packet rate")));
+            }
+            else if (args[i] == "--profile") {
+                scanner.set_profiling(true);
+            }
             else {
                 throw std::runtime_error("Unknown option: " + args[i]);
             }
@@ -1,13 +1,23 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <map>
 #include <ctime>
+#include <cstring>
+#include <cctype>
 #include <iomanip>
 #include <filesystem>
 #include <algorithm>
 #include <sstream>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "advbox_core.hpp"
+
 namespace fs = std::filesystem;
 
 const char* HELP = R"(
@@ -49,11 +59,76 @@ struct Note {
     std::vector<std::string> tags;
 };
 
+// Zero-copy variant of Note used by read-only commands: every field is a
+// view into the mmap'd log, so listing or exporting touches the page
+// cache directly and allocates only the per-note tag vector. Views are
+// valid for as long as the mapping is (mutations never reuse them).
+struct NoteView {
+    int id = 0;
+    std::string_view text;
+    std::string_view date;
+    std::vector<std::string_view> tags;
+};
+
+// notes.db is an append-only log of the same record blocks the old format
+// used (#id, @date, *tags, text, blank line). A later record for an id
+// supersedes earlier ones, and a record whose body is a single '!' line is
+// a tombstone. notes.idx maps id -> (offset, length) of each live record,
+// so single-note operations seek straight to one block instead of parsing
+// the whole log, and mutations append one record instead of rewriting the
+// file. When more than half the log is dead records, compaction rewrites
+// it with only the live ones.
+struct IndexEntry {
+    uint32_t id;
+    uint64_t offset;
+    uint32_t length;
+};
+
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t log_size;
+    uint64_t live_bytes;
+    uint64_t count;
+};
+
+// notes.six holds the search index: lowercase token -> note ids, plus
+// every three-byte window of the lowercased text -> note ids. A search
+// intersects the posting lists of the query's trigrams to get a small
+// candidate set and only then verifies the actual substring, so queries
+// stay substring-accurate without rescanning every note. The header
+// records the log size the index was built against; a mismatch (log
+// written by an older build) triggers a one-time rebuild.
+struct SearchHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t log_size;
+    uint64_t token_count;
+    uint64_t trigram_count;
+};
+
 class NotesManager {
 private:
     const std::string NOTES_DIR = std::string(getenv("HOME")) + "/.notes";
     const std::string DB_FILE = NOTES_DIR + "/notes.db";
-    std::vector<Note> notes;
+    const std::string IDX_FILE = NOTES_DIR + "/notes.idx";
+    const std::string SIX_FILE = NOTES_DIR + "/notes.six";
+
+    std::vector<IndexEntry> index; // sorted by id
+    uint64_t log_size = 0;
+    uint64_t live_bytes = 0;
+
+    // Scratch space for record blocks read back out of the log; reset
+    // and reused per record, so load_all and compaction parse every
+    // record without a heap allocation each.
+    advbox::Arena scratch;
+
+    void* log_map = nullptr;
+    size_t log_map_len = 0;
+
+    bool search_index_loaded = false;
+    std::map<std::string, std::vector<uint32_t>> token_postings;
+    std::map<std::string, std::vector<uint32_t>> trigram_postings;
 
     void ensure_notes_dir() {
         if (!fs::exists(NOTES_DIR)) {
@@ -64,215 +139,599 @@ private:
     std::string get_current_date() {
         auto now = std::time(nullptr);
         auto tm = *std::localtime(&now);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-        return oss.str();
+        char buf[32];
+        size_t len = std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+        return std::string(buf, len);
+    }
+
+    uint64_t db_size() {
+        std::error_code ec;
+        uint64_t size = fs::file_size(DB_FILE, ec);
+        return ec ? 0 : size;
+    }
+
+    bool load_index() {
+        std::ifstream file(IDX_FILE, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        IndexHeader hdr{};
+        if (!file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) ||
+            std::memcmp(hdr.magic, "NIDX", 4) != 0 || hdr.version != 1 ||
+            hdr.log_size != db_size()) {
+            // Missing, foreign, or stale (log was written without us)
+            return false;
+        }
+
+        index.resize(hdr.count);
+        if (hdr.count > 0 &&
+            !file.read(reinterpret_cast<char*>(index.data()),
+                       hdr.count * sizeof(IndexEntry))) {
+            index.clear();
+            return false;
+        }
+
+        log_size = hdr.log_size;
+        live_bytes = hdr.live_bytes;
+        return true;
+    }
+
+    void save_index() {
+        IndexHeader hdr{};
+        std::memcpy(hdr.magic, "NIDX", 4);
+        hdr.version = 1;
+        hdr.log_size = log_size;
+        hdr.live_bytes = live_bytes;
+        hdr.count = index.size();
+
+        std::ofstream file(IDX_FILE, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        if (!index.empty()) {
+            file.write(reinterpret_cast<const char*>(index.data()),
+                       index.size() * sizeof(IndexEntry));
+        }
+    }
+
+    // Full scan of the log; only runs when the index is missing or stale.
+    // Record boundaries are '#' lines that follow a blank line (or the
+    // start of the file), so note bodies containing '#' mid-record are
+    // left alone.
+    void rebuild_index() {
+        index.clear();
+        log_size = db_size();
+        live_bytes = 0;
+
+        std::map<uint32_t, IndexEntry> live;
+        std::ifstream file(DB_FILE, std::ios::binary);
+        if (file) {
+            std::string line;
+            uint64_t offset = 0;
+            uint64_t rec_start = 0;
+            long cur_id = -1;
+            bool cur_tombstone = false;
+            bool prev_blank = true;
+            bool after_header = false;
+
+            auto finish_record = [&](uint64_t end_offset) {
+                if (cur_id < 0) return;
+                uint64_t end = std::min<uint64_t>(end_offset, log_size);
+                if (cur_tombstone) {
+                    live.erase(static_cast<uint32_t>(cur_id));
+                } else {
+                    live[cur_id] = IndexEntry{
+                        static_cast<uint32_t>(cur_id), rec_start,
+                        static_cast<uint32_t>(end - rec_start)};
+                }
+            };
+
+            while (std::getline(file, line)) {
+                uint64_t line_start = offset;
+                offset += line.size() + 1;
+
+                if (!line.empty() && line[0] == '#' && prev_blank) {
+                    finish_record(line_start);
+                    rec_start = line_start;
+                    cur_id = std::strtol(line.c_str() + 1, nullptr, 10);
+                    cur_tombstone = false;
+                    after_header = true;
+                } else {
+                    // A tombstone is exactly "#id\n!\n\n" — the '!' must be
+                    // the whole line and follow the header directly, so a
+                    // note whose text merely starts with '!' is kept.
+                    if (line == "!" && cur_id >= 0 && after_header) {
+                        cur_tombstone = true;
+                    }
+                    after_header = false;
+                }
+                prev_blank = line.empty();
+            }
+            finish_record(offset);
+        }
+
+        index.reserve(live.size());
+        for (const auto& [id, entry] : live) {
+            index.push_back(entry);
+            live_bytes += entry.length;
+        }
+        save_index();
     }
 
-    void load_notes() {
-        notes.clear();
-        std::ifstream file(DB_FILE);
-        if (!file) return;
+    std::vector<IndexEntry>::iterator find_entry(int id) {
+        auto it = std::lower_bound(index.begin(), index.end(), id,
+            [](const IndexEntry& e, int want) {
+                return static_cast<int>(e.id) < want;
+            });
+        if (it == index.end() || static_cast<int>(it->id) != id) {
+            return index.end();
+        }
+        return it;
+    }
 
-        std::string line;
-        Note current_note;
-        while (std::getline(file, line)) {
+    // Zero-copy over the record buffer: lines and tags are walked as
+    // string_views and only the fields that survive into the Note are
+    // copied (the istringstream version allocated per line).
+    static Note parse_record(std::string_view buf) {
+        Note note{};
+        advbox::Splitter lines(buf, '\n');
+        std::string_view line;
+        while (lines.next(line)) {
             if (line.empty()) continue;
-            
-            if (line[0] == '#') { // New note
-                if (current_note.id != 0) {
-                    notes.push_back(current_note);
+
+            if (line[0] == '#') {
+                int64_t id;
+                if (advbox::parse_i64(line.substr(1), id)) {
+                    note.id = static_cast<int>(id);
                 }
-                current_note = Note();
-                current_note.id = std::stoi(line.substr(1));
-            }
-            else if (line[0] == '@') { // Date
-                current_note.date = line.substr(1);
-            }
-            else if (line[0] == '*') { // Tags
-                std::string tags = line.substr(1);
-                std::stringstream ss(tags);
-                std::string tag;
-                while (std::getline(ss, tag, ',')) {
-                    current_note.tags.push_back(tag);
+            }
+            else if (line[0] == '@') {
+                note.date.assign(line.substr(1));
+            }
+            else if (line[0] == '*') {
+                advbox::Splitter tags(line.substr(1), ',');
+                std::string_view tag;
+                while (tags.next(tag)) {
+                    note.tags.emplace_back(tag);
                 }
             }
-            else { // Note body
-                if (!current_note.text.empty()) {
-                    current_note.text += "\n";
+            else {
+                if (!note.text.empty()) {
+                    note.text += '\n';
                 }
-                current_note.text += line;
+                note.text.append(line);
             }
         }
-        
-        if (current_note.id != 0) {
-            notes.push_back(current_note);
+        return note;
+    }
+
+    static std::string format_record(const Note& note) {
+        char id_buf[24];
+        size_t id_len = advbox::format_i64(id_buf, note.id);
+
+        std::string out;
+        out.reserve(note.text.size() + note.date.size() + 64);
+        out += '#';
+        out.append(id_buf, id_len);
+        out += '\n';
+        out += '@';
+        out += note.date;
+        out += '\n';
+        if (!note.tags.empty()) {
+            out += '*';
+            for (size_t i = 0; i < note.tags.size(); ++i) {
+                if (i > 0) out += ',';
+                out += note.tags[i];
+            }
+            out += '\n';
         }
+        out += note.text;
+        out += "\n\n";
+        return out;
     }
 
-    void save_notes() {
-        std::ofstream file(DB_FILE);
-        for (const auto& note : notes) {
-            file << "#" << note.id << "\n";
-            file << "@" << note.date << "\n";
-            if (!note.tags.empty()) {
-                file << "*";
-                for (size_t i = 0; i < note.tags.size(); ++i) {
-                    if (i > 0) file << ",";
-                    file << note.tags[i];
+    // Appends one record block and updates the in-memory index entry; the
+    // log is never rewritten in place.
+    void append_record(const Note& note) {
+        std::string record = format_record(note);
+
+        std::ofstream file(DB_FILE, std::ios::binary | std::ios::app);
+        file.write(record.data(), record.size());
+        file.flush();
+
+        IndexEntry entry{static_cast<uint32_t>(note.id), log_size,
+                         static_cast<uint32_t>(record.size())};
+        log_size += record.size();
+
+        auto it = find_entry(note.id);
+        if (it != index.end()) {
+            live_bytes -= it->length;
+            *it = entry;
+        } else {
+            index.insert(std::upper_bound(index.begin(), index.end(), entry,
+                [](const IndexEntry& a, const IndexEntry& b) {
+                    return a.id < b.id;
+                }), entry);
+        }
+        live_bytes += entry.length;
+    }
+
+    void append_tombstone(int id) {
+        std::string record = "#" + std::to_string(id) + "\n!\n\n";
+
+        std::ofstream file(DB_FILE, std::ios::binary | std::ios::app);
+        file.write(record.data(), record.size());
+        file.flush();
+        log_size += record.size();
+
+        auto it = find_entry(id);
+        if (it != index.end()) {
+            live_bytes -= it->length;
+            index.erase(it);
+        }
+    }
+
+    bool map_log() {
+        if (log_map) {
+            return true;
+        }
+        if (log_size == 0) {
+            return false;
+        }
+        int fd = open(DB_FILE.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        void* map = mmap(nullptr, log_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+        log_map = map;
+        log_map_len = log_size;
+        return true;
+    }
+
+    // Parses one record straight out of the mapping. Text lines are
+    // contiguous in a record, so the whole body is a single view; nothing
+    // in the format needs unescaping, so nothing is copied.
+    NoteView view_record_at(const IndexEntry& entry) {
+        NoteView note;
+        std::string_view buf(static_cast<const char*>(log_map) + entry.offset,
+                             entry.length);
+
+        size_t text_begin = std::string_view::npos;
+        size_t text_end = 0;
+        size_t pos = 0;
+        while (pos < buf.size()) {
+            size_t eol = buf.find('\n', pos);
+            if (eol == std::string_view::npos) {
+                eol = buf.size();
+            }
+            std::string_view line = buf.substr(pos, eol - pos);
+
+            if (!line.empty()) {
+                if (line[0] == '#') {
+                    int id = 0;
+                    for (char c : line.substr(1)) {
+                        if (c < '0' || c > '9') break;
+                        id = id * 10 + (c - '0');
+                    }
+                    note.id = id;
+                }
+                else if (line[0] == '@') {
+                    note.date = line.substr(1);
+                }
+                else if (line[0] == '*') {
+                    std::string_view tags = line.substr(1);
+                    size_t start = 0;
+                    while (start <= tags.size()) {
+                        size_t comma = tags.find(',', start);
+                        if (comma == std::string_view::npos) {
+                            note.tags.push_back(tags.substr(start));
+                            break;
+                        }
+                        note.tags.push_back(tags.substr(start, comma - start));
+                        start = comma + 1;
+                    }
+                }
+                else {
+                    if (text_begin == std::string_view::npos) {
+                        text_begin = pos;
+                    }
+                    text_end = eol;
                 }
-                file << "\n";
             }
-            file << note.text << "\n\n";
+            pos = eol + 1;
         }
+
+        if (text_begin != std::string_view::npos) {
+            note.text = buf.substr(text_begin, text_end - text_begin);
+        }
+        return note;
     }
 
-    int get_next_id() {
-        if (notes.empty()) return 1;
-        return notes.back().id + 1;
+    std::vector<NoteView> load_all_views() {
+        std::vector<NoteView> notes;
+        notes.reserve(index.size());
+        for (const auto& entry : index) {
+            notes.push_back(view_record_at(entry));
+        }
+        return notes;
     }
 
-public:
-    NotesManager() {
-        ensure_notes_dir();
-        load_notes();
+    Note read_note_at(const IndexEntry& entry) {
+        std::ifstream file(DB_FILE, std::ios::binary);
+        file.seekg(entry.offset);
+        scratch.reset();
+        char* buf = static_cast<char*>(scratch.alloc(entry.length));
+        file.read(buf, entry.length);
+        return parse_record(std::string_view(buf, entry.length));
     }
 
-    void add_note(const std::string& text, const std::vector<std::string>& tags = {}) {
-        Note note;
-        note.id = get_next_id();
-        note.text = text;
-        note.date = get_current_date();
-        note.tags = tags;
-        notes.push_back(note);
-        save_notes();
-        std::cout << "Note added with ID: " << note.id << "\n";
+    Note fetch_note(int id) {
+        auto it = find_entry(id);
+        if (it == index.end()) {
+            throw std::runtime_error("Note not found");
+        }
+        return read_note_at(*it);
     }
 
-    void list_notes(const std::string& tag = "") {
-        if (notes.empty()) {
-            std::cout << "No notes found.\n";
+    std::vector<Note> load_all() {
+        std::vector<Note> notes;
+        notes.reserve(index.size());
+        for (const auto& entry : index) {
+            notes.push_back(read_note_at(entry));
+        }
+        return notes;
+    }
+
+    // Rewrites the log with only live records once more than half of it
+    // is superseded records and tombstones.
+    void maybe_compact() {
+        if (log_size < 4096 || live_bytes * 2 > log_size) {
             return;
         }
 
-        for (const auto& note : notes) {
-            if (!tag.empty() && 
-                std::find(note.tags.begin(), note.tags.end(), tag) == note.tags.end()) {
-                continue;
+        std::string tmp = DB_FILE + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            uint64_t offset = 0;
+            for (auto& entry : index) {
+                std::string record = format_record(read_note_at(entry));
+                file.write(record.data(), record.size());
+                entry.offset = offset;
+                entry.length = static_cast<uint32_t>(record.size());
+                offset += record.size();
             }
+            log_size = offset;
+            live_bytes = offset;
+        }
+        fs::rename(tmp, DB_FILE);
+    }
 
-            std::cout << "\033[1;32m#" << note.id << "\033[0m ";
-            std::cout << "\033[1;34m[" << note.date << "]\033[0m ";
-            
-            if (!note.tags.empty()) {
-                std::cout << "\033[1;33m";
-                for (const auto& tag : note.tags) {
-                    std::cout << "#" << tag << " ";
-                }
-                std::cout << "\033[0m";
-            }
-            
-            std::cout << "\n";
-            
-            // Show the first 50 characters of the note
-            std::string preview = note.text.substr(0, 50);
-            if (note.text.length() > 50) {
-                preview += "...";
+    int get_next_id() {
+        if (index.empty()) return 1;
+        return static_cast<int>(index.back().id) + 1;
+    }
+
+    static std::string to_lower(const std::string& text) {
+        std::string out = text;
+        std::transform(out.begin(), out.end(), out.begin(),
+            [](unsigned char c) { return std::tolower(c); });
+        return out;
+    }
+
+    static std::vector<std::string> tokenize(const std::string& text) {
+        std::vector<std::string> tokens;
+        std::string current;
+        for (unsigned char c : text) {
+            if (std::isalnum(c)) {
+                current.push_back(static_cast<char>(std::tolower(c)));
+            } else if (!current.empty()) {
+                tokens.push_back(std::move(current));
+                current.clear();
             }
-            std::cout << preview << "\n\n";
         }
+        if (!current.empty()) {
+            tokens.push_back(std::move(current));
+        }
+        std::sort(tokens.begin(), tokens.end());
+        tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+        return tokens;
     }
 
-    void show_note(int id) {
-        auto it = std::find_if(notes.begin(), notes.end(),
-            [id](const Note& n) { return n.id == id; });
-        
-        if (it == notes.end()) {
-            throw std::runtime_error("Note not found");
+    static std::vector<std::string> trigrams_of(const std::string& text) {
+        std::vector<std::string> grams;
+        std::string lower = to_lower(text);
+        for (size_t i = 0; i + 3 <= lower.size(); ++i) {
+            grams.push_back(lower.substr(i, 3));
         }
+        std::sort(grams.begin(), grams.end());
+        grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        return grams;
+    }
 
-        std::cout << "\033[1;32m#" << it->id << "\033[0m ";
-        std::cout << "\033[1;34m[" << it->date << "]\033[0m\n";
-        
-        if (!it->tags.empty()) {
-            std::cout << "\033[1;33m";
-            for (const auto& tag : it->tags) {
-                std::cout << "#" << tag << " ";
-            }
-            std::cout << "\033[0m\n";
+    static void postings_add(std::map<std::string, std::vector<uint32_t>>& map,
+                             const std::string& key, uint32_t id) {
+        auto& list = map[key];
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (it == list.end() || *it != id) {
+            list.insert(it, id);
         }
-        
-        std::cout << "\n" << it->text << "\n";
     }
 
-    void edit_note(int id, const std::string& new_text) {
-        auto it = std::find_if(notes.begin(), notes.end(),
-            [id](const Note& n) { return n.id == id; });
-        
-        if (it == notes.end()) {
-            throw std::runtime_error("Note not found");
+    static void postings_remove(std::map<std::string, std::vector<uint32_t>>& map,
+                                const std::string& key, uint32_t id) {
+        auto map_it = map.find(key);
+        if (map_it == map.end()) return;
+        auto& list = map_it->second;
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (it != list.end() && *it == id) {
+            list.erase(it);
         }
+        if (list.empty()) {
+            map.erase(map_it);
+        }
+    }
 
-        it->text = new_text;
-        it->date = get_current_date() + " (edited)";
-        save_notes();
-        std::cout << "Note updated.\n";
+    void index_note_text(uint32_t id, const std::string& text) {
+        for (const auto& token : tokenize(text)) {
+            postings_add(token_postings, token, id);
+        }
+        for (const auto& gram : trigrams_of(text)) {
+            postings_add(trigram_postings, gram, id);
+        }
     }
 
-    void remove_note(int id) {
-        auto it = std::find_if(notes.begin(), notes.end(),
-            [id](const Note& n) { return n.id == id; });
-        
-        if (it == notes.end()) {
-            throw std::runtime_error("Note not found");
+    void unindex_note_text(uint32_t id, const std::string& text) {
+        for (const auto& token : tokenize(text)) {
+            postings_remove(token_postings, token, id);
         }
+        for (const auto& gram : trigrams_of(text)) {
+            postings_remove(trigram_postings, gram, id);
+        }
+    }
 
-        notes.erase(it);
-        save_notes();
-        std::cout << "Note removed.\n";
+    static void write_postings(std::ofstream& file,
+                               const std::map<std::string, std::vector<uint32_t>>& map) {
+        for (const auto& [key, ids] : map) {
+            uint32_t len = static_cast<uint32_t>(key.size());
+            uint32_t n = static_cast<uint32_t>(ids.size());
+            file.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            file.write(key.data(), len);
+            file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+            file.write(reinterpret_cast<const char*>(ids.data()),
+                       n * sizeof(uint32_t));
+        }
     }
 
-    void search_notes(const std::string& query) {
-        bool found = false;
-        for (const auto& note : notes) {
-            if (note.text.find(query) != std::string::npos) {
-                if (!found) {
-                    std::cout << "Search results:\n\n";
-                    found = true;
-                }
-                show_note(note.id);
-                std::cout << "\n";
+    static bool read_postings(std::ifstream& file, uint64_t count,
+                              std::map<std::string, std::vector<uint32_t>>& map) {
+        for (uint64_t i = 0; i < count; ++i) {
+            uint32_t len, n;
+            if (!file.read(reinterpret_cast<char*>(&len), sizeof(len))) return false;
+            std::string key(len, '\0');
+            if (!file.read(key.data(), len)) return false;
+            if (!file.read(reinterpret_cast<char*>(&n), sizeof(n))) return false;
+            std::vector<uint32_t> ids(n);
+            if (n > 0 &&
+                !file.read(reinterpret_cast<char*>(ids.data()),
+                           n * sizeof(uint32_t))) return false;
+            map.emplace(std::move(key), std::move(ids));
+        }
+        return true;
+    }
+
+    bool load_search_index() {
+        std::ifstream file(SIX_FILE, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        SearchHeader hdr{};
+        if (!file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) ||
+            std::memcmp(hdr.magic, "NSIX", 4) != 0 || hdr.version != 1 ||
+            hdr.log_size != log_size) {
+            return false;
+        }
+
+        if (!read_postings(file, hdr.token_count, token_postings) ||
+            !read_postings(file, hdr.trigram_count, trigram_postings)) {
+            token_postings.clear();
+            trigram_postings.clear();
+            return false;
+        }
+        return true;
+    }
+
+    void save_search_index() {
+        SearchHeader hdr{};
+        std::memcpy(hdr.magic, "NSIX", 4);
+        hdr.version = 1;
+        hdr.log_size = log_size;
+        hdr.token_count = token_postings.size();
+        hdr.trigram_count = trigram_postings.size();
+
+        std::ofstream file(SIX_FILE, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        write_postings(file, token_postings);
+        write_postings(file, trigram_postings);
+    }
+
+    void ensure_search_index() {
+        if (search_index_loaded) {
+            return;
+        }
+        if (!load_search_index()) {
+            // Rebuild once from the live notes
+            token_postings.clear();
+            trigram_postings.clear();
+            for (const auto& note : load_all()) {
+                index_note_text(note.id, note.text);
             }
+            save_search_index();
         }
-        
-        if (!found) {
-            std::cout << "No matching notes found.\n";
+        search_index_loaded = true;
+    }
+
+    template <typename NoteT>
+    void print_note(const NoteT& note) {
+        std::cout << "\033[1;32m#" << note.id << "\033[0m ";
+        std::cout << "\033[1;34m[" << note.date << "]\033[0m\n";
+
+        if (!note.tags.empty()) {
+            std::cout << "\033[1;33m";
+            for (const auto& tag : note.tags) {
+                std::cout << "#" << tag << " ";
+            }
+            std::cout << "\033[0m\n";
         }
+
+        std::cout << "\n" << note.text << "\n";
     }
 
-    void add_tags(int id, const std::vector<std::string>& new_tags) {
-        auto it = std::find_if(notes.begin(), notes.end(),
-            [id](const Note& n) { return n.id == id; });
-        
-        if (it == notes.end()) {
-            throw std::runtime_error("Note not found");
+    template <typename NoteT>
+    void list_notes_impl(const std::vector<NoteT>& notes, const std::string& tag) {
+        if (notes.empty()) {
+            std::cout << "No notes found.\n";
+            return;
         }
 
-        for (const auto& tag : new_tags) {
-            if (std::find(it->tags.begin(), it->tags.end(), tag) == it->tags.end()) {
-                it->tags.push_back(tag);
+        for (const auto& note : notes) {
+            if (!tag.empty() &&
+                std::find(note.tags.begin(), note.tags.end(), tag) == note.tags.end()) {
+                continue;
             }
+
+            std::cout << "\033[1;32m#" << note.id << "\033[0m ";
+            std::cout << "\033[1;34m[" << note.date << "]\033[0m ";
+
+            if (!note.tags.empty()) {
+                std::cout << "\033[1;33m";
+                for (const auto& tag : note.tags) {
+                    std::cout << "#" << tag << " ";
+                }
+                std::cout << "\033[0m";
+            }
+
+            std::cout << "\n";
+
+            // Show the first 50 characters of the note
+            std::string preview(note.text.substr(0, 50));
+            if (note.text.length() > 50) {
+                preview += "...";
+            }
+            std::cout << preview << "\n\n";
         }
-        save_notes();
-        std::cout << "Tags added.\n";
     }
 
-    void list_tags() {
-        std::vector<std::string> all_tags;
+    template <typename NoteT>
+    void list_tags_impl(const std::vector<NoteT>& notes) {
+        std::vector<std::string_view> all_tags;
         for (const auto& note : notes) {
             all_tags.insert(all_tags.end(), note.tags.begin(), note.tags.end());
         }
-        
+
         std::sort(all_tags.begin(), all_tags.end());
         all_tags.erase(std::unique(all_tags.begin(), all_tags.end()), all_tags.end());
 
@@ -284,14 +743,15 @@ public:
         std::cout << "Available tags:\n";
         for (const auto& tag : all_tags) {
             size_t count = std::count_if(notes.begin(), notes.end(),
-                [&tag](const Note& n) {
+                [&tag](const NoteT& n) {
                     return std::find(n.tags.begin(), n.tags.end(), tag) != n.tags.end();
                 });
             std::cout << "\033[1;33m#" << tag << "\033[0m (" << count << ")\n";
         }
     }
 
-    void export_notes(const std::string& format = "text") {
+    template <typename NoteT>
+    void export_notes_impl(const std::vector<NoteT>& notes, const std::string& format) {
         if (format == "json") {
             std::cout << "{\n  \"notes\": [\n";
             for (size_t i = 0; i < notes.size(); ++i) {
@@ -326,6 +786,208 @@ public:
             }
         }
     }
+
+public:
+    NotesManager() {
+        ensure_notes_dir();
+        if (!load_index()) {
+            rebuild_index();
+        }
+    }
+
+    ~NotesManager() {
+        if (log_map) {
+            munmap(log_map, log_map_len);
+        }
+    }
+
+    void add_note(const std::string& text, const std::vector<std::string>& tags = {}) {
+        Note note;
+        note.id = get_next_id();
+        note.text = text;
+        note.date = get_current_date();
+        note.tags = tags;
+        ensure_search_index();
+        index_note_text(note.id, note.text);
+        append_record(note);
+        maybe_compact();
+        save_index();
+        save_search_index();
+        std::cout << "Note added with ID: " << note.id << "\n";
+    }
+
+    void list_notes(const std::string& tag = "") {
+        if (map_log()) {
+            list_notes_impl(load_all_views(), tag);
+        } else {
+            list_notes_impl(load_all(), tag);
+        }
+    }
+
+    void show_note(int id) {
+        auto it = find_entry(id);
+        if (it == index.end()) {
+            throw std::runtime_error("Note not found");
+        }
+        if (map_log()) {
+            print_note(view_record_at(*it));
+        } else {
+            print_note(read_note_at(*it));
+        }
+    }
+
+    void edit_note(int id, const std::string& new_text) {
+        Note note = fetch_note(id);
+        ensure_search_index();
+        unindex_note_text(note.id, note.text);
+        note.text = new_text;
+        note.date = get_current_date() + " (edited)";
+        index_note_text(note.id, note.text);
+        append_record(note);
+        maybe_compact();
+        save_index();
+        save_search_index();
+        std::cout << "Note updated.\n";
+    }
+
+    void remove_note(int id) {
+        Note note = fetch_note(id);
+        ensure_search_index();
+        unindex_note_text(note.id, note.text);
+        append_tombstone(id);
+        maybe_compact();
+        save_index();
+        save_search_index();
+        std::cout << "Note removed.\n";
+    }
+
+    void search_notes(const std::string& query) {
+        bool found = false;
+
+        std::string lower_query = to_lower(query);
+        if (lower_query.size() >= 3) {
+            ensure_search_index();
+
+            // Intersect the posting lists of the query's trigrams; a note
+            // containing the substring necessarily contains every trigram
+            std::vector<uint32_t> candidates;
+            bool first = true;
+            for (size_t i = 0; i + 3 <= lower_query.size(); ++i) {
+                auto it = trigram_postings.find(lower_query.substr(i, 3));
+                const std::vector<uint32_t> empty;
+                const auto& postings = (it != trigram_postings.end())
+                                           ? it->second : empty;
+                if (first) {
+                    candidates = postings;
+                    first = false;
+                } else {
+                    std::vector<uint32_t> merged;
+                    std::set_intersection(candidates.begin(), candidates.end(),
+                                          postings.begin(), postings.end(),
+                                          std::back_inserter(merged));
+                    candidates = std::move(merged);
+                }
+                if (candidates.empty()) {
+                    break;
+                }
+            }
+
+            // A whole-word query can also be answered from the token list;
+            // merge it in so both paths stay consistent
+            auto tok = token_postings.find(lower_query);
+            if (tok != token_postings.end()) {
+                std::vector<uint32_t> merged;
+                std::set_union(candidates.begin(), candidates.end(),
+                               tok->second.begin(), tok->second.end(),
+                               std::back_inserter(merged));
+                candidates = std::move(merged);
+            }
+
+            // Verify the actual substring so results match a full scan
+            bool mapped = map_log();
+            for (uint32_t id : candidates) {
+                auto entry = find_entry(static_cast<int>(id));
+                if (entry == index.end()) continue;
+                if (mapped) {
+                    NoteView note = view_record_at(*entry);
+                    if (note.text.find(query) == std::string_view::npos) continue;
+                    if (!found) {
+                        std::cout << "Search results:\n\n";
+                        found = true;
+                    }
+                    print_note(note);
+                } else {
+                    Note note = read_note_at(*entry);
+                    if (note.text.find(query) == std::string::npos) continue;
+                    if (!found) {
+                        std::cout << "Search results:\n\n";
+                        found = true;
+                    }
+                    print_note(note);
+                }
+                std::cout << "\n";
+            }
+        } else if (map_log()) {
+            // Queries shorter than a trigram fall back to a full scan
+            for (const auto& note : load_all_views()) {
+                if (note.text.find(query) != std::string_view::npos) {
+                    if (!found) {
+                        std::cout << "Search results:\n\n";
+                        found = true;
+                    }
+                    print_note(note);
+                    std::cout << "\n";
+                }
+            }
+        } else {
+            for (const auto& note : load_all()) {
+                if (note.text.find(query) != std::string::npos) {
+                    if (!found) {
+                        std::cout << "Search results:\n\n";
+                        found = true;
+                    }
+                    print_note(note);
+                    std::cout << "\n";
+                }
+            }
+        }
+
+        if (!found) {
+            std::cout << "No matching notes found.\n";
+        }
+    }
+
+    void add_tags(int id, const std::vector<std::string>& new_tags) {
+        Note note = fetch_note(id);
+
+        for (const auto& tag : new_tags) {
+            if (std::find(note.tags.begin(), note.tags.end(), tag) == note.tags.end()) {
+                note.tags.push_back(tag);
+            }
+        }
+        ensure_search_index();
+        append_record(note);
+        maybe_compact();
+        save_index();
+        save_search_index(); // Text is unchanged; refresh the recorded log size
+        std::cout << "Tags added.\n";
+    }
+
+    void list_tags() {
+        if (map_log()) {
+            list_tags_impl(load_all_views());
+        } else {
+            list_tags_impl(load_all());
+        }
+    }
+
+    void export_notes(const std::string& format = "text") {
+        if (map_log()) {
+            export_notes_impl(load_all_views(), format);
+        } else {
+            export_notes_impl(load_all(), format);
+        }
+    }
 };
 
 std::vector<std::string> split_tags(const std::string& tags_str) {
@@ -343,7 +1005,7 @@ std::vector<std::string> split_tags(const std::string& tags_str) {
 int main(int argc, char* argv[]) {
     try {
         std::vector<std::string> args(argv + 1, argv + argc);
-        
+
         if (args.empty() || args[0] == "-h" || args[0] == "--help") {
             std::cout << HELP;
             return 0;
@@ -379,19 +1041,19 @@ int main(int argc, char* argv[]) {
             if (args.size() < 2) {
                 throw std::runtime_error("Note ID required");
             }
-            manager.show_note(std::stoi(args[1]));
+            manager.show_note(static_cast<int>(advbox::to_i64(args[1], "note id")));
         }
         else if (command == "edit") {
             if (args.size() < 3) {
                 throw std::runtime_error("Note ID and new text required");
             }
-            manager.edit_note(std::stoi(args[1]), args[2]);
+            manager.edit_note(static_cast<int>(advbox::to_i64(args[1], "note id")), args[2]);
         }
         else if (command == "rm") {
             if (args.size() < 2) {
                 throw std::runtime_error("Note ID required");
             }
-            manager.remove_note(std::stoi(args[1]));
+            manager.remove_note(static_cast<int>(advbox::to_i64(args[1], "note id")));
         }
         else if (command == "search") {
             if (args.size() < 2) {
@@ -403,7 +1065,7 @@ int main(int argc, char* argv[]) {
             if (args.size() < 3) {
                 throw std::runtime_error("Note ID and tags required");
             }
-            manager.add_tags(std::stoi(args[1]), split_tags(args[2]));
+            manager.add_tags(static_cast<int>(advbox::to_i64(args[1], "note id")), split_tags(args[2]));
         }
         else if (command == "tags") {
             manager.list_tags();
@@ -426,4 +1088,4 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << '\n'; std::cerr << "Try 'notes --help' for more information.\n"; return 1; } }
\ No newline at end of file
+        std::cerr << "Error: " << e.what() << '\n'; std::cerr << "Try 'notes --help' for more information.\n"; return 1; } }
@@ -3,12 +3,20 @@
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
 
 #define DEFAULT_WIDTH 50
 #define MIN_WIDTH 10
 #define MAX_WIDTH 150
 #define UPDATE_DELAY 100000  // 100ms
 
+#define PIPE_CHUNK (1 << 20)     // bytes moved per splice call
+#define FRAME_INTERVAL 0.1       // seconds between meter frames
+
 static int progress_width = DEFAULT_WIDTH;
 static volatile sig_atomic_t stop = 0;
 
@@ -26,38 +34,43 @@ void clear_line() {
 
 void show_help() {
     printf("Usage: progress [OPTIONS] <value>\n");
-    printf("Shows an animated progress bar (0-100%%)\n\n");
+    printf("       cmd | progress --pipe [-s SIZE] | cmd2\n");
+    printf("Shows an animated progress bar (0-100%%) or meters a pipe\n\n");
     printf("Options:\n");
     printf("  -w <width>   Set progress bar width (10-150, default: 50)\n");
+    printf("  -p, --pipe   Pass stdin to stdout and show throughput,\n");
+    printf("               total bytes and ETA on stderr\n");
+    printf("  -s <bytes>   Expected total size for the pipe meter\n");
+    printf("               (taken from stdin if it is a regular file)\n");
     printf("  -h           Show this help message\n\n");
     printf("Example:\n");
-    printf("  progress 75          # Show 75%% progress\n");
-    printf("  progress -w 100 50   # Show 50%% progress with width 100\n");
+    printf("  progress 75                        # Show 75%% progress\n");
+    printf("  progress -w 100 50                 # Show 50%% progress with width 100\n");
+    printf("  progress --pipe < big.img | gzip > big.img.gz\n");
+    printf("  tar c dir | progress -p -s 5000000000 | ssh host 'tar x'\n");
 }
 
 void draw_progress(int percentage) {
+    // One frame is built in a buffer and emitted with a single write
+    // so a refresh never tears or costs one syscall per character.
+    char frame[MAX_WIDTH + 32];
     int filled = (progress_width * percentage) / 100;
     int empty = progress_width - filled;
+    int pos = 0;
 
-    printf("\r[");
-
-    // Filled portion
-    for(int i = 0; i < filled; i++) {
-        printf("=");
-    }
-
-    // Progress cursor
+    frame[pos++] = '\r';
+    frame[pos++] = '[';
+    memset(frame + pos, '=', filled);
+    pos += filled;
     if (percentage < 100) {
-        printf(">");
+        frame[pos++] = '>';
         empty--;
     }
+    memset(frame + pos, ' ', empty);
+    pos += empty;
+    pos += snprintf(frame + pos, sizeof(frame) - pos, "] %3d%%", percentage);
 
-    // Empty portion
-    for(int i = 0; i < empty; i++) {
-        printf(" ");
-    }
-
-    printf("] %3d%%", percentage);
+    fwrite(frame, 1, pos, stdout);
     fflush(stdout);
 }
 
@@ -82,8 +95,161 @@ int animate_progress(int target_percentage) {
     return 0;
 }
 
+/*
+ * Pipe meter: pass stdin through to stdout with splice(2) so payload
+ * bytes move between the pipe buffers in the kernel and never cross
+ * user space, while throughput, total bytes and ETA render on stderr.
+ * When neither end is a pipe (splice returns EINVAL) the loop falls
+ * back to a plain read/write copy.
+ */
+
+static double now_monotonic(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void format_bytes(double v, char *buf, size_t cap) {
+    static const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB", "PiB"};
+    int u = 0;
+    while (v >= 1024.0 && u < 5) {
+        v /= 1024.0;
+        u++;
+    }
+    snprintf(buf, cap, u == 0 ? "%.0f %s" : "%.1f %s", v, units[u]);
+}
+
+static void format_duration(long secs, char *buf, size_t cap) {
+    if (secs >= 3600) {
+        snprintf(buf, cap, "%ld:%02ld:%02ld", secs / 3600, (secs / 60) % 60, secs % 60);
+    } else {
+        snprintf(buf, cap, "%ld:%02ld", secs / 60, secs % 60);
+    }
+}
+
+static void render_meter(uint64_t total, double rate, double elapsed,
+                         int64_t expected, int final) {
+    char bytes_s[32], rate_s[32], time_s[32];
+    char frame[MAX_WIDTH + 128];
+    int pos = 0;
+
+    format_bytes((double)total, bytes_s, sizeof(bytes_s));
+    format_bytes(rate, rate_s, sizeof(rate_s));
+
+    frame[pos++] = '\r';
+    pos += snprintf(frame + pos, sizeof(frame) - pos, "%10s ", bytes_s);
+
+    if (expected > 0) {
+        int pct = total >= (uint64_t)expected ? 100
+                : (int)((double)total * 100.0 / (double)expected);
+        int filled = (progress_width * pct) / 100;
+        int empty = progress_width - filled;
+        frame[pos++] = '[';
+        memset(frame + pos, '=', filled);
+        pos += filled;
+        if (pct < 100 && empty > 0) {
+            frame[pos++] = '>';
+            empty--;
+        }
+        memset(frame + pos, ' ', empty);
+        pos += empty;
+        long eta = 0;
+        if (rate > 0 && (uint64_t)expected > total) {
+            eta = (long)(((double)expected - (double)total) / rate);
+        }
+        format_duration(eta, time_s, sizeof(time_s));
+        pos += snprintf(frame + pos, sizeof(frame) - pos,
+                        "] %3d%%  %s/s  ETA %s  ", pct, rate_s, time_s);
+    } else {
+        format_duration((long)elapsed, time_s, sizeof(time_s));
+        pos += snprintf(frame + pos, sizeof(frame) - pos,
+                        " %s/s  %s elapsed  ", rate_s, time_s);
+    }
+
+    if (final) {
+        frame[pos++] = '\n';
+    }
+    write(STDERR_FILENO, frame, pos);
+}
+
+static int run_pipe(int64_t expected) {
+    signal(SIGINT, signal_handler);
+
+    if (expected <= 0) {
+        struct stat st;
+        if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode)) {
+            expected = (int64_t)st.st_size;
+        }
+    }
+
+    static char fallback[1 << 18];
+    int use_splice = 1;
+    uint64_t total = 0, last_total = 0;
+    double start = now_monotonic();
+    double last_frame = start;
+    double rate = 0.0;
+    int meter = isatty(STDERR_FILENO);
+
+    while (!stop) {
+        ssize_t n;
+        if (use_splice) {
+            n = splice(STDIN_FILENO, NULL, STDOUT_FILENO, NULL,
+                       PIPE_CHUNK, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (n < 0 && (errno == EINVAL || errno == ENOSYS)) {
+                use_splice = 0;  // neither end is a pipe
+                continue;
+            }
+        } else {
+            n = read(STDIN_FILENO, fallback, sizeof(fallback));
+            if (n > 0) {
+                ssize_t off = 0;
+                while (off < n) {
+                    ssize_t w = write(STDOUT_FILENO, fallback + off, n - off);
+                    if (w < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        fprintf(stderr, "\nError: write: %s\n", strerror(errno));
+                        return 1;
+                    }
+                    off += w;
+                }
+            }
+        }
+        if (n == 0) {
+            break;  // end of input
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "\nError: %s\n", strerror(errno));
+            return 1;
+        }
+        total += (uint64_t)n;
+
+        if (meter) {
+            double now = now_monotonic();
+            if (now - last_frame >= FRAME_INTERVAL) {
+                double inst = (double)(total - last_total) / (now - last_frame);
+                rate = rate == 0.0 ? inst : 0.7 * rate + 0.3 * inst;
+                render_meter(total, rate, now - start, expected, 0);
+                last_frame = now;
+                last_total = total;
+            }
+        }
+    }
+
+    double elapsed = now_monotonic() - start;
+    render_meter(total, elapsed > 0 ? (double)total / elapsed : 0.0,
+                 elapsed, expected, 1);
+    return stop ? 1 : 0;
+}
+
 int main(int argc, char *argv[]) {
     int percentage = 0;
+    int pipe_mode = 0;
+    int64_t expected = 0;
     int i = 1;
 
     // Parse arguments
@@ -108,12 +274,32 @@ int main(int argc, char *argv[]) {
 
             i += 2;
         }
+        else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--pipe") == 0) {
+            pipe_mode = 1;
+            i++;
+        }
+        else if (strcmp(argv[i], "-s") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: Size value is missing\n");
+                return 1;
+            }
+            expected = atoll(argv[i + 1]);
+            if (expected <= 0) {
+                fprintf(stderr, "Error: Size must be a positive byte count\n");
+                return 1;
+            }
+            i += 2;
+        }
         else {
             percentage = atoi(argv[i]);
             i++;
         }
     }
 
+    if (pipe_mode) {
+        return run_pipe(expected);
+    }
+
     // Validate percentage value
     if (percentage < 0 || percentage > 100) {
         fprintf(stderr, "Error: Percentage must be between 0 and 100\n");
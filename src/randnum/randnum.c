@@ -1,17 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <time.h>
 #include <unistd.h>
 #include <ctype.h>
 
-#define MAX_NUMBERS 1000
-
 void show_help() {
     printf("Usage: randnum [OPTIONS] <min> <max>\n");
     printf("Generate random numbers in specified range\n\n");
     printf("Options:\n");
-    printf("  -n <count>   Number of random numbers to generate (default: 1, max: 1000)\n");
+    printf("  -n <count>   Number of random numbers to generate (default: 1)\n");
     printf("  -u           Ensure unique numbers (no duplicates)\n");
     printf("  -s           Sort output numbers\n");
     printf("  -c           Output in comma-separated format\n");
@@ -22,39 +21,163 @@ void show_help() {
     printf("  randnum -u -n 3 1 5    # Generate 3 unique numbers between 1 and 5\n");
 }
 
-// Comparator for qsort
-int compare(const void* a, const void* b) {
-    return (*(long*)a - *(long*)b);
+/*
+ * xoshiro256** PRNG, seeded through splitmix64. Fast, good statistical
+ * quality, and a 64-bit output per call — unlike rand(), whose 31-bit
+ * output had to be combined and biased with % for large ranges.
+ */
+static uint64_t rng_state[4];
+
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
 }
 
-// Check whether a number already exists in the array
-int number_exists(long* numbers, int count, long number) {
-    for(int i = 0; i < count; i++) {
-        if(numbers[i] == number) {
-            return 1;
+static void rng_seed(void) {
+    uint64_t seed = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        seed ^= (uint64_t)ts.tv_nsec * 0x2545f4914f6cdd1dULL;
+    }
+    for (int i = 0; i < 4; i++) {
+        rng_state[i] = splitmix64(&seed);
+    }
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t rng_next(void) {
+    uint64_t result = rotl(rng_state[1] * 5, 7) * 9;
+    uint64_t t = rng_state[1] << 17;
+
+    rng_state[2] ^= rng_state[0];
+    rng_state[3] ^= rng_state[1];
+    rng_state[1] ^= rng_state[2];
+    rng_state[0] ^= rng_state[3];
+    rng_state[2] ^= t;
+    rng_state[3] = rotl(rng_state[3], 45);
+
+    return result;
+}
+
+/* Unbiased draw in [0, bound); bound == 0 means the full 64-bit range. */
+static uint64_t rng_below(uint64_t bound) {
+    if (bound == 0) {
+        return rng_next();
+    }
+    uint64_t threshold = -bound % bound;
+    for (;;) {
+        uint64_t r = rng_next();
+        if (r >= threshold) {
+            return r % bound;
         }
     }
+}
+
+/*
+ * Sparse Fisher-Yates state: unique draws are the prefix of a random
+ * permutation of the range, but the range can be astronomically larger
+ * than the draw count, so only the displaced positions are stored, in
+ * an open-addressing map keyed by position. O(count) time and memory,
+ * no retry loops and no membership scans.
+ */
+typedef struct {
+    uint64_t *keys;  /* position + 1; 0 marks an empty slot */
+    uint64_t *vals;
+    size_t mask;
+} SwapMap;
+
+static int swapmap_init(SwapMap *m, size_t count) {
+    size_t cap = 16;
+    while (cap < count * 2) {
+        cap <<= 1;
+    }
+    m->keys = calloc(cap, sizeof(uint64_t));
+    m->vals = malloc(cap * sizeof(uint64_t));
+    m->mask = cap - 1;
+    if (!m->keys || !m->vals) {
+        free(m->keys);
+        free(m->vals);
+        return -1;
+    }
     return 0;
 }
 
+static uint64_t swapmap_get(const SwapMap *m, uint64_t pos) {
+    size_t i = (pos * 0x9e3779b97f4a7c15ULL) & m->mask;
+    while (m->keys[i] != 0) {
+        if (m->keys[i] == pos + 1) {
+            return m->vals[i];
+        }
+        i = (i + 1) & m->mask;
+    }
+    return pos;  /* never displaced: still holds its own value */
+}
+
+static void swapmap_set(SwapMap *m, uint64_t pos, uint64_t val) {
+    size_t i = (pos * 0x9e3779b97f4a7c15ULL) & m->mask;
+    while (m->keys[i] != 0 && m->keys[i] != pos + 1) {
+        i = (i + 1) & m->mask;
+    }
+    m->keys[i] = pos + 1;
+    m->vals[i] = val;
+}
+
+// Comparator for qsort
+int compare(const void* a, const void* b) {
+    long x = *(const long*)a;
+    long y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+/* Buffered bulk output: format into a 1 MB buffer, flush as it fills. */
+#define OUT_BUF (1 << 20)
+
+static void flush_out(char *buf, size_t *len) {
+    fwrite(buf, 1, *len, stdout);
+    *len = 0;
+}
+
+static void put_long(char *buf, size_t *len, long value) {
+    if (*len + 24 > OUT_BUF) {
+        flush_out(buf, len);
+    }
+    char tmp[24];
+    int t = 0;
+    unsigned long u = (value < 0) ? (unsigned long)(-(value + 1)) + 1 : (unsigned long)value;
+    do {
+        tmp[t++] = '0' + (char)(u % 10);
+        u /= 10;
+    } while (u > 0);
+    if (value < 0) {
+        buf[(*len)++] = '-';
+    }
+    while (t > 0) {
+        buf[(*len)++] = tmp[--t];
+    }
+}
+
 int main(int argc, char *argv[]) {
     long min = 0, max = 0;
-    int count = 1;
+    long long count = 1;
     int unique = 0;
     int sort = 0;
     int comma = 0;
     int opt;
 
-    // Seed the random number generator
-    srand(time(NULL) ^ getpid());
+    rng_seed();
 
     // Parse options
     while ((opt = getopt(argc, argv, "n:usch")) != -1) {
         switch (opt) {
             case 'n':
-                count = atoi(optarg);
-                if (count < 1 || count > MAX_NUMBERS) {
-                    fprintf(stderr, "Error: Count must be between 1 and %d\n", MAX_NUMBERS);
+                count = atoll(optarg);
+                if (count < 1) {
+                    fprintf(stderr, "Error: Count must be at least 1\n");
                     return 1;
                 }
                 break;
@@ -93,9 +216,12 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    /* Width of the range; 0 encodes a full 2^64 span. */
+    uint64_t range = (uint64_t)(max - min) + 1;
+
     // Check that the range is large enough for unique generation
-    if (unique && (max - min + 1) < count) {
-        fprintf(stderr, "Error: Range too small for %d unique numbers\n", count);
+    if (unique && range != 0 && range < (uint64_t)count) {
+        fprintf(stderr, "Error: Range too small for %lld unique numbers\n", count);
         return 1;
     }
 
@@ -107,20 +233,26 @@ int main(int argc, char *argv[]) {
     }
 
     // Generate numbers
-    for(int i = 0; i < count; i++) {
-        long range = max - min + 1;
-        long number;
-
-        do {
-            // Use a more accurate method for large ranges
-            if (range > RAND_MAX) {
-                number = min + ((long)rand() * RAND_MAX + rand()) % range;
-            } else {
-                number = min + rand() % range;
-            }
-        } while (unique && number_exists(numbers, i, number));
-
-        numbers[i] = number;
+    if (unique) {
+        SwapMap swaps;
+        if (swapmap_init(&swaps, count) != 0) {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            free(numbers);
+            return 1;
+        }
+        for (long long i = 0; i < count; i++) {
+            /* Pick j uniformly in [i, range); with range == 0 the
+             * uint64 wraparound gives the right bound of 2^64 - i. */
+            uint64_t j = (uint64_t)i + rng_below(range - (uint64_t)i);
+            numbers[i] = min + (long)swapmap_get(&swaps, j);
+            swapmap_set(&swaps, j, swapmap_get(&swaps, (uint64_t)i));
+        }
+        free(swaps.keys);
+        free(swaps.vals);
+    } else {
+        for (long long i = 0; i < count; i++) {
+            numbers[i] = min + (long)rng_below(range);
+        }
     }
 
     // Sort if requested
@@ -129,21 +261,30 @@ int main(int argc, char *argv[]) {
     }
 
     // Print results
-    for(int i = 0; i < count; i++) {
+    char *out = malloc(OUT_BUF);
+    if (!out) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        free(numbers);
+        return 1;
+    }
+    size_t olen = 0;
+    for (long long i = 0; i < count; i++) {
         if (comma && i > 0) {
-            printf(", ");
+            out[olen++] = ',';
+            out[olen++] = ' ';
         }
-        printf("%ld", numbers[i]);
+        put_long(out, &olen, numbers[i]);
         if (!comma) {
-            printf("\n");
+            out[olen++] = '\n';
         }
     }
-
     if (comma) {
-        printf("\n");
+        out[olen++] = '\n';
     }
+    flush_out(out, &olen);
 
     // Free memory
+    free(out);
     free(numbers);
     return 0;
 }
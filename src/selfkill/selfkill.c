@@ -7,18 +7,29 @@
 #include <dirent.h>
 #include <ctype.h>
 #include <time.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
 #include <errno.h>
 
-#define MAX_PROCESSES 1024
-#define MAX_PATH 256
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
 #define WAIT_TIME 2
+#define STATUS_BUF 1024
 
 // Structure for storing process information
 typedef struct {
     pid_t pid;
-    char name[256];
+    int pidfd;      // pins the process against PID reuse; -1 if unavailable
+    char name[32];  // comm is at most 15 chars
 } ProcessInfo;
 
 // List of processes that must not be terminated
@@ -29,6 +40,47 @@ const char *protected_processes[] = {
     NULL
 };
 
+/*
+ * Protected-name lookup goes through a small open-addressing hash set
+ * built once at startup, so the per-process check in the snapshot loop
+ * is O(1) instead of a strcmp against every list entry. Matching is
+ * exact on the comm value (the old substring match also caught e.g.
+ * "bash-helper", which was never intended).
+ */
+#define PROT_BUCKETS 64  // power of two, well above the list size
+
+static const char *prot_set[PROT_BUCKETS];
+
+static uint32_t hash_name(const char *s) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void build_protected_set(void) {
+    for (const char **p = protected_processes; *p; p++) {
+        uint32_t i = hash_name(*p) & (PROT_BUCKETS - 1);
+        while (prot_set[i]) {
+            i = (i + 1) & (PROT_BUCKETS - 1);
+        }
+        prot_set[i] = *p;
+    }
+}
+
+static int is_protected(const char *name) {
+    uint32_t i = hash_name(name) & (PROT_BUCKETS - 1);
+    while (prot_set[i]) {
+        if (strcmp(prot_set[i], name) == 0) {
+            return 1;
+        }
+        i = (i + 1) & (PROT_BUCKETS - 1);
+    }
+    return 0;
+}
+
 void show_help() {
     printf("Usage: selfkill [OPTIONS]\n");
     printf("Terminate all processes owned by current user\n\n");
@@ -41,91 +93,130 @@ void show_help() {
     printf("user processes. Use with caution!\n");
 }
 
-// Check whether a process is protected
-int is_protected(const char *name) {
-    for (const char **p = protected_processes; *p; p++) {
-        if (strstr(name, *p) != NULL) {
-            return 1;
-        }
-    }
-    return 0;
-}
-
-// Get process name by PID
-int get_process_name(pid_t pid, char *name, size_t size) {
-    char path[MAX_PATH];
-    char buf[MAX_PATH];
-    FILE *fp;
+// Read name and uid from /proc/PID/status in a single open/read.
+static int read_status(pid_t pid, char *name, size_t name_size, uid_t *uid) {
+    char path[64];
+    char buf[STATUS_BUF];
 
-    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
-    fp = fopen(path, "r");
-
-    if (fp) {
-        if (fgets(buf, sizeof(buf), fp)) {
-            buf[strcspn(buf, "\n")] = 0; // Strip newline
-            strncpy(name, buf, size - 1);
-            name[size - 1] = '\0';
-            fclose(fp);
-            return 1;
-        }
-        fclose(fp);
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;  // process already gone
     }
-    return 0;
-}
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0) {
+        return 0;
+    }
+    buf[n] = '\0';
 
-// Check whether a process belongs to the given user
-int is_user_process(pid_t pid, uid_t uid) {
-    char path[MAX_PATH];
-    struct stat st;
+    // "Name:" is the first line; "Uid:" holds real uid first.
+    if (strncmp(buf, "Name:\t", 6) != 0) {
+        return 0;
+    }
+    const char *p = buf + 6;
+    size_t len = strcspn(p, "\n");
+    if (len >= name_size) {
+        len = name_size - 1;
+    }
+    memcpy(name, p, len);
+    name[len] = '\0';
 
-    snprintf(path, sizeof(path), "/proc/%d", pid);
-    if (stat(path, &st) == 0) {
-        return st.st_uid == uid;
+    const char *u = strstr(buf, "\nUid:\t");
+    if (!u) {
+        return 0;
     }
-    return 0;
+    *uid = (uid_t)strtoul(u + 6, NULL, 10);
+    return 1;
 }
 
-// Build list of processes owned by the user
-int get_user_processes(uid_t uid, ProcessInfo *processes, int max_procs, int verbose) {
-    DIR *dir;
-    struct dirent *ent;
-    int count = 0;
-
-    dir = opendir("/proc");
+/*
+ * One snapshot pass over /proc. Each candidate is pinned with
+ * pidfd_open BEFORE its status is read: if the PID is recycled
+ * between the two steps the pidfd still refers to the original
+ * (now dead) process, so a later signal can never land on the
+ * wrong one. On kernels without pidfds (or when the fd table is
+ * full) the entry falls back to a plain kill by PID.
+ */
+static ProcessInfo *snapshot_processes(uid_t uid, int verbose, int want_pidfd,
+                                       int *out_count) {
+    *out_count = -1;  // distinguishes errors from an empty snapshot
+    DIR *dir = opendir("/proc");
     if (!dir) {
         perror("Failed to open /proc");
-        return -1;
+        return NULL;
     }
 
-    while ((ent = readdir(dir)) != NULL && count < max_procs) {
-        // Only process numeric directory names (PIDs)
-        if (!isdigit(*ent->d_name)) {
-            continue;
+    // One fd per target; lift the soft limit so 30k+ candidates fit.
+    if (want_pidfd) {
+        struct rlimit rl;
+        if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+            rl.rlim_cur = rl.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &rl);
         }
+    }
+
+    ProcessInfo *processes = NULL;
+    int count = 0;
+    int capacity = 0;
+    pid_t self = getpid();
+    struct dirent *ent;
 
+    while ((ent = readdir(dir)) != NULL) {
+        if (!isdigit((unsigned char)*ent->d_name)) {
+            continue;
+        }
         pid_t pid = atoi(ent->d_name);
+        if (pid == self) {
+            continue;
+        }
 
-        // Skip the current process
-        if (pid == getpid()) {
+        int pidfd = -1;
+        if (want_pidfd) {
+            pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+        }
+
+        char name[32];
+        uid_t proc_uid;
+        if (!read_status(pid, name, sizeof(name), &proc_uid)
+            || proc_uid != uid || is_protected(name)) {
+            if (pidfd >= 0) {
+                close(pidfd);
+            }
             continue;
         }
 
-        if (is_user_process(pid, uid)) {
-            processes[count].pid = pid;
-            if (get_process_name(pid, processes[count].name, sizeof(processes[0].name))) {
-                if (!is_protected(processes[count].name)) {
-                    if (verbose) {
-                        printf("Found process: %s (PID: %d)\n",
-                               processes[count].name, processes[count].pid);
-                    }
-                    count++;
-                }
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            ProcessInfo *grown = realloc(processes, capacity * sizeof(*processes));
+            if (!grown) {
+                perror("Out of memory");
+                free(processes);
+                closedir(dir);
+                return NULL;
             }
+            processes = grown;
         }
+        processes[count].pid = pid;
+        processes[count].pidfd = pidfd;
+        strcpy(processes[count].name, name);
+        if (verbose) {
+            printf("Found process: %s (PID: %d)\n", name, pid);
+        }
+        count++;
     }
 
     closedir(dir);
-    return count;
+    *out_count = count;
+    return processes;
+}
+
+// Signal one snapshot entry, through its pidfd when available.
+static int signal_process(const ProcessInfo *proc, int sig) {
+    if (proc->pidfd >= 0) {
+        return (int)syscall(SYS_pidfd_send_signal, proc->pidfd, sig, NULL, 0);
+    }
+    return kill(proc->pid, sig);
 }
 
 // Log the action taken
@@ -147,7 +238,6 @@ void log_action(const char *username, int process_count, int force_kill) {
 }
 
 int main(int argc, char *argv[]) {
-    ProcessInfo processes[MAX_PROCESSES];
     int force_kill = 0;
     int list_only = 0;
     int verbose = 0;
@@ -174,6 +264,8 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    build_protected_set();
+
     // Get current user information
     uid_t uid = getuid();
     struct passwd *pw = getpwuid(uid);
@@ -184,8 +276,9 @@ int main(int argc, char *argv[]) {
 
     printf("User: %s (UID: %d)\n", pw->pw_name, uid);
 
-    // Build the process list
-    int count = get_user_processes(uid, processes, MAX_PROCESSES, verbose);
+    // Take the snapshot (pidfds are only needed when we will signal)
+    int count = 0;
+    ProcessInfo *processes = snapshot_processes(uid, verbose, !list_only, &count);
     if (count < 0) {
         fprintf(stderr, "Error: Failed to get process list\n");
         return 1;
@@ -195,6 +288,7 @@ int main(int argc, char *argv[]) {
 
     if (count == 0) {
         printf("No processes to terminate\n");
+        free(processes);
         return 0;
     }
 
@@ -204,6 +298,7 @@ int main(int argc, char *argv[]) {
         for (int i = 0; i < count; i++) {
             printf("%5d: %s\n", processes[i].pid, processes[i].name);
         }
+        free(processes);
         return 0;
     }
 
@@ -217,7 +312,7 @@ int main(int argc, char *argv[]) {
     int success_count = 0;
 
     for (int i = 0; i < count; i++) {
-        if (kill(processes[i].pid, signal_type) == 0) {
+        if (signal_process(&processes[i], signal_type) == 0) {
             if (verbose) {
                 printf("Terminated: %s (PID: %d)\n",
                        processes[i].name, processes[i].pid);
@@ -227,7 +322,11 @@ int main(int argc, char *argv[]) {
             printf("Failed to terminate: %s (PID: %d) - %s\n",
                    processes[i].name, processes[i].pid, strerror(errno));
         }
+        if (processes[i].pidfd >= 0) {
+            close(processes[i].pidfd);
+        }
     }
+    free(processes);
 
     // Log the result
     log_action(pw->pw_name, success_count, force_kill);
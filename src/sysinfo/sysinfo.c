@@ -2,7 +2,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/socket.h>
 #include <sys/sysinfo.h>
+#include <sys/un.h>
 #include <sys/utsname.h>
 #include <sys/statvfs.h>
 #include <pwd.h>
@@ -139,18 +144,165 @@ void show_help() {
     printf("Usage: sysinfo [OPTIONS]\n");
     printf("Display system information\n\n");
     printf("Options:\n");
-    printf("  -c    Show CPU information only\n");
-    printf("  -m    Show memory information only\n");
-    printf("  -d    Show disk information only\n");
-    printf("  -h    Show this help message\n");
+    printf("  -c              Show CPU information only\n");
+    printf("  -m              Show memory information only\n");
+    printf("  -d              Show disk information only\n");
+    printf("  -w, --watch N   Sample every N seconds, one JSON line per sample\n");
+    printf("      --socket P  In watch mode, write samples to unix socket P\n");
+    printf("  -h              Show this help message\n");
+}
+
+/*
+ * Watch mode: a long-lived sampler for fleet dashboards. Each /proc
+ * file is opened once; every tick re-reads it with pread() into a
+ * fixed buffer and parses in place, so a sample costs a few preads
+ * and no fork/open/malloc. One JSON line per sample goes to stdout
+ * or a unix socket.
+ */
+
+#define WATCH_BUF 8192
+
+/* Parse the decimal number following the first occurrence of key. */
+static unsigned long find_ulong(const char *buf, const char *key) {
+    const char *p = strstr(buf, key);
+    if (p == NULL) {
+        return 0;
+    }
+    p += strlen(key);
+    while (*p == ' ') p++;
+    return strtoul(p, NULL, 10);
+}
+
+static int read_proc(int fd, char *buf, size_t cap) {
+    ssize_t n = pread(fd, buf, cap - 1, 0);
+    if (n < 0) {
+        n = 0;
+    }
+    buf[n] = '\0';
+    return (int)n;
+}
+
+static int open_proc(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "sysinfo: cannot open %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+static int connect_unix_socket(const char *path) {
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "sysinfo: socket path too long\n");
+        exit(1);
+    }
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("sysinfo: socket");
+        exit(1);
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "sysinfo: cannot connect to %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    return fd;
+}
+
+static int run_watch(int interval, const char *socket_path) {
+    int fd_loadavg = open_proc("/proc/loadavg");
+    int fd_meminfo = open_proc("/proc/meminfo");
+    int fd_stat = open_proc("/proc/stat");
+    int out_fd = socket_path ? connect_unix_socket(socket_path) : STDOUT_FILENO;
+
+    struct utsname un;
+    if (uname(&un) < 0) {
+        perror("uname");
+        return 1;
+    }
+    long ncores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    char buf[WATCH_BUF];
+    char out[1024];
+    unsigned long long prev_busy = 0, prev_total = 0;
+    struct timespec tick = { interval, 0 };
+
+    for (;;) {
+        /* CPU utilization from the aggregate line of /proc/stat. */
+        read_proc(fd_stat, buf, sizeof(buf));
+        unsigned long long st[8] = {0};
+        sscanf(buf, "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+               &st[0], &st[1], &st[2], &st[3], &st[4], &st[5], &st[6], &st[7]);
+        unsigned long long idle = st[3] + st[4];
+        unsigned long long total = 0;
+        for (int i = 0; i < 8; i++) {
+            total += st[i];
+        }
+        unsigned long long busy = total - idle;
+        double cpu_pct = 0.0;
+        if (prev_total != 0 && total > prev_total) {
+            cpu_pct = 100.0 * (double)(busy - prev_busy) / (double)(total - prev_total);
+        }
+        prev_busy = busy;
+        prev_total = total;
+
+        float load[3] = {0};
+        read_proc(fd_loadavg, buf, sizeof(buf));
+        sscanf(buf, "%f %f %f", &load[0], &load[1], &load[2]);
+
+        read_proc(fd_meminfo, buf, sizeof(buf));
+        unsigned long mem_total = find_ulong(buf, "MemTotal:") * 1024;
+        unsigned long mem_free = find_ulong(buf, "MemFree:") * 1024;
+        unsigned long mem_buffers = find_ulong(buf, "Buffers:") * 1024;
+        unsigned long mem_cached = find_ulong(buf, "\nCached:") * 1024;
+        unsigned long mem_used = mem_total - mem_free - mem_buffers - mem_cached;
+
+        struct statvfs fs;
+        unsigned long disk_total = 0, disk_free = 0;
+        if (statvfs("/", &fs) == 0) {
+            disk_total = (unsigned long)fs.f_blocks * fs.f_frsize;
+            disk_free = (unsigned long)fs.f_bfree * fs.f_frsize;
+        }
+
+        int len = snprintf(out, sizeof(out),
+            "{\"ts\":%ld,\"host\":\"%s\",\"cores\":%ld,"
+            "\"load1\":%.2f,\"load5\":%.2f,\"load15\":%.2f,\"cpu_pct\":%.1f,"
+            "\"mem_total\":%lu,\"mem_used\":%lu,\"mem_free\":%lu,"
+            "\"mem_cached\":%lu,\"mem_buffers\":%lu,"
+            "\"disk_total\":%lu,\"disk_used\":%lu,\"disk_free\":%lu}\n",
+            (long)time(NULL), un.nodename, ncores,
+            load[0], load[1], load[2], cpu_pct,
+            mem_total, mem_used, mem_free, mem_cached, mem_buffers,
+            disk_total, disk_total - disk_free, disk_free);
+
+        if (write(out_fd, out, len) < 0) {
+            /* Consumer went away (closed pipe/socket); stop quietly. */
+            return 0;
+        }
+
+        nanosleep(&tick, NULL);
+    }
 }
 
 int main(int argc, char *argv[]) {
     int show_cpu = 1, show_mem = 1, show_disk = 1;
+    int watch_interval = 0;
+    const char *socket_path = NULL;
     int opt;
 
+    static const struct option long_opts[] = {
+        {"watch", required_argument, NULL, 'w'},
+        {"socket", required_argument, NULL, 'S'},
+        {NULL, 0, NULL, 0},
+    };
+
     // Parse options
-    while ((opt = getopt(argc, argv, "cmdhp")) != -1) {
+    while ((opt = getopt_long(argc, argv, "cmdhpw:", long_opts, NULL)) != -1) {
         switch (opt) {
             case 'c':
                 show_mem = show_disk = 0;
@@ -161,6 +313,16 @@ int main(int argc, char *argv[]) {
             case 'd':
                 show_cpu = show_mem = 0;
                 break;
+            case 'w':
+                watch_interval = atoi(optarg);
+                if (watch_interval <= 0) {
+                    fprintf(stderr, "sysinfo: invalid watch interval\n");
+                    return 1;
+                }
+                break;
+            case 'S':
+                socket_path = optarg;
+                break;
             case 'h':
                 show_help();
                 return 0;
@@ -170,6 +332,10 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (watch_interval > 0) {
+        return run_watch(watch_interval, socket_path);
+    }
+
     struct utsname un;
     if (uname(&un) < 0) {
         perror("uname");
@@ -2,10 +2,18 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
 #include <ctime>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Usage help text
 const char* HELP = R"(
@@ -15,6 +23,7 @@ Usage:
     tzconvert [OPTIONS] <time> [source_timezone] [target_timezone]
     tzconvert -l | --list         List available time zones
     tzconvert -n | --now [tz]     Show current time in timezone (default: local)
+    tzconvert --stream FROM TO    Convert timestamps line-by-line from stdin
 
 Options:
     -h, --help     Show this help message
@@ -29,11 +38,20 @@ Time format:
     HH:MM:SS (today's date is assumed)
     now (current time)
 
+Stream mode:
+    tzconvert --stream FROM TO
+                   Read one 'YYYY-MM-DD HH:MM:SS' timestamp per line
+                   from stdin and write the converted timestamp per
+                   line. Built for bulk log normalization: both zones
+                   are loaded once and the loop is pure integer
+                   arithmetic over the transition tables.
+
 Examples:
     tzconvert now UTC America/New_York
     tzconvert "2025-02-25 15:30:00" Europe/London Asia/Tokyo
     tzconvert -u -s "14:00:00" America/Los_Angeles
     tzconvert -l
+    tzconvert --stream UTC America/New_York < access.log.times
 )";
 
 // Date/time structure
@@ -57,7 +75,10 @@ struct DateTime {
     }
 };
 
-// UTC offset map for common timezones (in seconds)
+// Fallback UTC offset map for systems without tzdata (in seconds).
+// Real conversions go through the TZif backend below; this map is
+// only consulted when /usr/share/zoneinfo has no file for the zone,
+// and it also drives --list.
 const std::map<std::string, int> TIMEZONE_OFFSETS = {
     {"UTC", 0},
     {"GMT", 0},
@@ -72,6 +93,346 @@ const std::map<std::string, int> TIMEZONE_OFFSETS = {
     {"Pacific/Auckland", 43200},    // UTC+12
 };
 
+// ---------------------------------------------------------------------------
+// TZif backend
+//
+// A zone is parsed once from its compiled tzdata file into a sorted
+// transition table and cached for the life of the process. Lookups
+// are then a binary search over the transitions, so they honour DST
+// and historical offset changes without any libc time calls.
+// ---------------------------------------------------------------------------
+
+const char* ZONEINFO_DIR = "/usr/share/zoneinfo";
+
+struct ZoneData {
+    std::vector<int64_t> transitions;   // UTC seconds, ascending
+    std::vector<int32_t> trans_offset;  // offset in effect from transitions[i]
+    int32_t initial_offset;             // offset before the first transition
+};
+
+uint32_t read_be32(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+int64_t read_be64(const unsigned char* p) {
+    return int64_t((uint64_t(read_be32(p)) << 32) | read_be32(p + 4));
+}
+
+// Parse one TZif data block starting at p. time_size is 4 for the
+// legacy v1 block and 8 for the 64-bit v2+ block. Returns the number
+// of bytes consumed.
+size_t parse_tzif_block(const unsigned char* p, const unsigned char* end,
+                        int time_size, ZoneData& zone) {
+    if (end - p < 44 || memcmp(p, "TZif", 4) != 0) {
+        throw std::runtime_error("Corrupt timezone file");
+    }
+    uint32_t timecnt = read_be32(p + 20 + 12);
+    uint32_t typecnt = read_be32(p + 20 + 16);
+    uint32_t charcnt = read_be32(p + 20 + 20);
+    uint32_t leapcnt = read_be32(p + 20 + 8);
+    uint32_t isstdcnt = read_be32(p + 20 + 4);
+    uint32_t isutcnt = read_be32(p + 20);
+
+    const unsigned char* data = p + 44;
+    size_t data_len = size_t(timecnt) * (time_size + 1) + size_t(typecnt) * 6 +
+                      charcnt + size_t(leapcnt) * (time_size + 4) +
+                      isstdcnt + isutcnt;
+    if (typecnt == 0 || size_t(end - data) < data_len) {
+        throw std::runtime_error("Corrupt timezone file");
+    }
+
+    const unsigned char* times = data;
+    const unsigned char* types = times + size_t(timecnt) * time_size;
+    const unsigned char* ttinfo = types + timecnt;
+
+    zone.transitions.clear();
+    zone.trans_offset.clear();
+    zone.transitions.reserve(timecnt);
+    zone.trans_offset.reserve(timecnt);
+
+    for (uint32_t i = 0; i < timecnt; ++i) {
+        int64_t when;
+        if (time_size == 8) {
+            when = read_be64(times + size_t(i) * 8);
+        } else {
+            when = int32_t(read_be32(times + size_t(i) * 4));
+        }
+        uint8_t type = types[i];
+        if (type >= typecnt) {
+            throw std::runtime_error("Corrupt timezone file");
+        }
+        zone.transitions.push_back(when);
+        zone.trans_offset.push_back(int32_t(read_be32(ttinfo + size_t(type) * 6)));
+    }
+
+    // Before the first transition the convention is the first
+    // standard-time (non-DST) type, falling back to type 0.
+    zone.initial_offset = int32_t(read_be32(ttinfo));
+    for (uint32_t t = 0; t < typecnt; ++t) {
+        if (ttinfo[size_t(t) * 6 + 4] == 0) {
+            zone.initial_offset = int32_t(read_be32(ttinfo + size_t(t) * 6));
+            break;
+        }
+    }
+
+    return 44 + data_len;
+}
+
+ZoneData parse_tzif(const unsigned char* p, size_t len) {
+    if (len < 44 || memcmp(p, "TZif", 4) != 0) {
+        throw std::runtime_error("Corrupt timezone file");
+    }
+    ZoneData zone;
+    char version = char(p[4]);
+    size_t consumed = parse_tzif_block(p, p + len, 4, zone);
+    if (version >= '2') {
+        // The v1 block only covers 32-bit time; re-parse from the
+        // 64-bit block that follows it.
+        parse_tzif_block(p + consumed, p + len, 8, zone);
+    }
+    return zone;
+}
+
+// Load and parse a zone file, or synthesize a fixed-offset zone from
+// TIMEZONE_OFFSETS when tzdata has no entry. Each zone is parsed at
+// most once per process.
+const ZoneData& load_zone(const std::string& name) {
+    static std::map<std::string, ZoneData> zone_cache;
+
+    auto it = zone_cache.find(name);
+    if (it != zone_cache.end()) {
+        return it->second;
+    }
+
+    if (name.empty() || name[0] == '/' || name.find("..") != std::string::npos) {
+        throw std::runtime_error("Unknown timezone: " + name);
+    }
+
+    std::string path = std::string(ZONEINFO_DIR) + "/" + name;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        auto fallback = TIMEZONE_OFFSETS.find(name);
+        if (fallback == TIMEZONE_OFFSETS.end()) {
+            throw std::runtime_error("Unknown timezone: " + name);
+        }
+        ZoneData fixed;
+        fixed.initial_offset = fallback->second;
+        return zone_cache.emplace(name, std::move(fixed)).first->second;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 44) {
+        close(fd);
+        throw std::runtime_error("Corrupt timezone file");
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("Cannot read timezone file: " + name);
+    }
+
+    try {
+        ZoneData zone = parse_tzif(static_cast<const unsigned char*>(map), st.st_size);
+        munmap(map, st.st_size);
+        return zone_cache.emplace(name, std::move(zone)).first->second;
+    } catch (...) {
+        munmap(map, st.st_size);
+        throw;
+    }
+}
+
+// UTC offset in effect at a given UTC timestamp.
+int32_t offset_at(const ZoneData& zone, int64_t utc) {
+    auto it = std::upper_bound(zone.transitions.begin(), zone.transitions.end(), utc);
+    if (it == zone.transitions.begin()) {
+        return zone.initial_offset;
+    }
+    return zone.trans_offset[(it - zone.transitions.begin()) - 1];
+}
+
+// Map a zone-local timestamp to UTC. The offset depends on the UTC
+// instant we are solving for, so refine an initial guess once; for
+// ambiguous or skipped local times (DST folds/gaps) this picks one
+// deterministic answer.
+int64_t local_to_utc(const ZoneData& zone, int64_t local) {
+    int32_t off = offset_at(zone, local);
+    off = offset_at(zone, local - off);
+    return local - offset_at(zone, local - off);
+}
+
+// Days since 1970-01-01 for a civil date (proleptic Gregorian).
+int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = unsigned(y - era * 400);
+    unsigned doy = (153 * unsigned(m + (m > 2 ? -3 : 9)) + 2) / 5 + unsigned(d) - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + int64_t(doe) - 719468;
+}
+
+// Inverse of days_from_civil.
+void civil_from_days(int64_t z, int& y, int& m, int& d) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = unsigned(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    d = int(doy - (153 * mp + 2) / 5 + 1);
+    m = int(mp + (mp < 10 ? 3 : -9));
+    y = int(yoe) + int(era) * 400 + (m <= 2);
+}
+
+int64_t datetime_to_seconds(const DateTime& dt) {
+    return days_from_civil(dt.year, dt.month, dt.day) * 86400 +
+           dt.hour * 3600 + dt.minute * 60 + dt.second;
+}
+
+DateTime seconds_to_datetime(int64_t t) {
+    int64_t days = t / 86400;
+    int64_t sod = t % 86400;
+    if (sod < 0) {
+        sod += 86400;
+        --days;
+    }
+    DateTime dt;
+    civil_from_days(days, dt.year, dt.month, dt.day);
+    dt.hour = int(sod / 3600);
+    dt.minute = int((sod % 3600) / 60);
+    dt.second = int(sod % 60);
+    return dt;
+}
+
+// ---------------------------------------------------------------------------
+// Stream mode
+//
+// Bulk conversion keeps the hot loop free of libc time calls and of
+// repeated binary searches: offset lookups cache the transition
+// interval currently in effect (log timestamps are nearly monotonic,
+// so the cache almost always hits), and the civil-date day number is
+// memoized per calendar day.
+// ---------------------------------------------------------------------------
+
+struct OffsetCache {
+    int64_t lo = 1, hi = 0;  // empty interval forces the first lookup
+    int32_t off = 0;
+};
+
+int32_t offset_at_cached(const ZoneData& zone, int64_t utc, OffsetCache& cache) {
+    if (utc < cache.lo || utc >= cache.hi) {
+        auto it = std::upper_bound(zone.transitions.begin(), zone.transitions.end(), utc);
+        size_t i = it - zone.transitions.begin();
+        cache.lo = (i == 0) ? INT64_MIN : zone.transitions[i - 1];
+        cache.hi = (i == zone.transitions.size()) ? INT64_MAX : zone.transitions[i];
+        cache.off = (i == 0) ? zone.initial_offset : zone.trans_offset[i - 1];
+    }
+    return cache.off;
+}
+
+// Parse exactly n ASCII digits; returns -1 on anything else.
+int parse_digits(const char* p, int n) {
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+        if (p[i] < '0' || p[i] > '9') return -1;
+        v = v * 10 + (p[i] - '0');
+    }
+    return v;
+}
+
+int run_stream(const std::string& from_tz, const std::string& to_tz) {
+    const ZoneData& from_zone = load_zone(from_tz);
+    const ZoneData& to_zone = load_zone(to_tz);
+    OffsetCache from_cache, to_cache;
+
+    // Memoized day-number for the most recent (year, month, day).
+    int last_y = 0, last_m = 0, last_d = 0;
+    int64_t last_days = 0;
+
+    std::vector<char> rbuf(1 << 20);
+    std::vector<char> obuf(1 << 20);
+    size_t carry = 0, olen = 0;
+    size_t line = 1;
+    bool eof = false;
+
+    while (!eof || carry > 0) {
+        size_t got = 0;
+        if (!eof) {
+            got = fread(rbuf.data() + carry, 1, rbuf.size() - carry, stdin);
+            if (got < rbuf.size() - carry) eof = true;
+        }
+        size_t have = carry + got;
+
+        const char* p = rbuf.data();
+        const char* end = rbuf.data() + have;
+        while (p < end) {
+            const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (!nl && !eof) break;  // partial line, refill
+            size_t len = (nl ? nl : end) - p;
+
+            if (len > 0) {
+                // Fixed-width 'YYYY-MM-DD HH:MM:SS' (trailing \r ok).
+                int y = -1, mo = -1, d = -1, h = -1, mi = -1, s = -1;
+                if (len >= 19 && p[4] == '-' && p[7] == '-' &&
+                    (p[10] == ' ' || p[10] == 'T') && p[13] == ':' && p[16] == ':') {
+                    y = parse_digits(p, 4);
+                    mo = parse_digits(p + 5, 2);
+                    d = parse_digits(p + 8, 2);
+                    h = parse_digits(p + 11, 2);
+                    mi = parse_digits(p + 14, 2);
+                    s = parse_digits(p + 17, 2);
+                }
+                if (y < 0 || mo < 0 || d < 0 || h < 0 || mi < 0 || s < 0) {
+                    throw std::runtime_error("Invalid timestamp on line "
+                                             + std::to_string(line));
+                }
+
+                if (y != last_y || mo != last_m || d != last_d) {
+                    last_days = days_from_civil(y, mo, d);
+                    last_y = y; last_m = mo; last_d = d;
+                }
+                int64_t local = last_days * 86400 + h * 3600 + mi * 60 + s;
+
+                int32_t off = offset_at_cached(from_zone, local, from_cache);
+                off = offset_at_cached(from_zone, local - off, from_cache);
+                int64_t utc = local - offset_at_cached(from_zone, local - off, from_cache);
+                int64_t out = utc + offset_at_cached(to_zone, utc, to_cache);
+
+                int64_t days = out / 86400;
+                int64_t sod = out % 86400;
+                if (sod < 0) { sod += 86400; --days; }
+                int oy, om, od;
+                civil_from_days(days, oy, om, od);
+
+                if (olen + 32 > obuf.size()) {
+                    fwrite(obuf.data(), 1, olen, stdout);
+                    olen = 0;
+                }
+                olen += snprintf(obuf.data() + olen, 32,
+                                 "%04d-%02d-%02d %02d:%02d:%02d\n",
+                                 oy, om, od, int(sod / 3600),
+                                 int((sod % 3600) / 60), int(sod % 60));
+            }
+
+            if (!nl) { p = end; break; }
+            p = nl + 1;
+            ++line;
+        }
+
+        carry = end - p;
+        memmove(rbuf.data(), p, carry);
+        if (carry == rbuf.size()) {
+            throw std::runtime_error("Line too long on line " + std::to_string(line));
+        }
+        if (eof && got == 0) carry = 0;
+    }
+
+    if (olen > 0) {
+        fwrite(obuf.data(), 1, olen, stdout);
+    }
+    return 0;
+}
+
 // Parse a time string into a DateTime
 DateTime parse_time(const std::string& time_str) {
     DateTime dt;
@@ -102,45 +463,18 @@ DateTime parse_time(const std::string& time_str) {
     return dt;
 }
 
-// Convert a DateTime from one timezone to another
-DateTime convert_timezone(const DateTime& dt, 
+// Convert a DateTime from one timezone to another. Both zones come
+// from the TZif cache, so the conversion is two table lookups plus
+// integer civil-date arithmetic — no mktime/gmtime round-trip, and
+// DST is handled correctly.
+DateTime convert_timezone(const DateTime& dt,
                         const std::string& from_tz,
                         const std::string& to_tz) {
-    // Look up the UTC offsets
-    auto from_it = TIMEZONE_OFFSETS.find(from_tz);
-    auto to_it = TIMEZONE_OFFSETS.find(to_tz);
-    
-    if (from_it == TIMEZONE_OFFSETS.end() || to_it == TIMEZONE_OFFSETS.end()) {
-        throw std::runtime_error("Unknown timezone");
-    }
-    
-    // Compute the offset difference in seconds
-    int offset_diff = to_it->second - from_it->second;
-    
-    // Convert to struct tm for arithmetic
-    struct tm tm_time = {};
-    tm_time.tm_year = dt.year - 1900;
-    tm_time.tm_mon = dt.month - 1;
-    tm_time.tm_mday = dt.day;
-    tm_time.tm_hour = dt.hour;
-    tm_time.tm_min = dt.minute;
-    tm_time.tm_sec = dt.second;
-    
-    // Convert to timestamp, apply the offset difference, then convert back
-    time_t timestamp = mktime(&tm_time);
-    timestamp += offset_diff;
-    
-    struct tm* new_time = gmtime(&timestamp);
-    
-    DateTime result;
-    result.year = new_time->tm_year + 1900;
-    result.month = new_time->tm_mon + 1;
-    result.day = new_time->tm_mday;
-    result.hour = new_time->tm_hour;
-    result.minute = new_time->tm_min;
-    result.second = new_time->tm_sec;
-    
-    return result;
+    const ZoneData& from_zone = load_zone(from_tz);
+    const ZoneData& to_zone = load_zone(to_tz);
+
+    int64_t utc = local_to_utc(from_zone, datetime_to_seconds(dt));
+    return seconds_to_datetime(utc + offset_at(to_zone, utc));
 }
 
 // Format a DateTime for output
@@ -205,8 +539,15 @@ int main(int argc, char* argv[]) {
         list_timezones();
         return 0;
     }
-    
+
     try {
+        if (args[0] == "--stream") {
+            if (args.size() < 3) {
+                throw std::runtime_error("--stream requires source and target timezones");
+            }
+            return run_stream(args[1], args[2]);
+        }
+
         bool use_utc = false;
         bool short_format = false;
         std::string format = "";